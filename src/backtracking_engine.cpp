@@ -0,0 +1,109 @@
+#include "backtracking_engine.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "board.h"
+
+using namespace std;
+using namespace sudoku;
+
+unsigned BacktrackingEngine::search(const Board &board,
+                                    const SolutionCallback &onSolution,
+                                    const ProgressCallback &onProgress) {
+    // Values placed in each line, column and section - a value fits in a
+    // position if it's in none of the three masks.
+    uint16_t lineMasks[Board::NUM_ROWS]{};
+    uint16_t colMasks[Board::NUM_COLS]{};
+    uint16_t secMasks[Board::NUM_ROWS]{};
+    uint8_t values[Board::NUM_POS];
+    // Gathers the empty cells, in line-major order.
+    uint8_t emptyCells[Board::NUM_POS];
+    size_t numEmptyCells = 0;
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        const uint8_t lin = pos / Board::NUM_COLS;
+        const uint8_t col = pos % Board::NUM_COLS;
+        values[pos] = board.valueAt(lin, col);
+        if (values[pos] == 0) {
+            emptyCells[numEmptyCells++] = pos;
+        } else {
+            const uint16_t bit =
+                static_cast<uint16_t>(1U << (values[pos] - 1U));
+            lineMasks[lin] |= bit;
+            colMasks[col] |= bit;
+            secMasks[lin / 3 * 3 + col / 3] |= bit;
+        }
+    }
+
+    // Index, in _candidates, of the next value to try at each empty cell.
+    uint8_t nextCandidates[Board::NUM_POS];
+    nextCandidates[0] = 0;
+    size_t currCellPos = 0;
+    bool boardUnsolvable = false;
+    while (currCellPos < numEmptyCells && !boardUnsolvable) {
+        const uint8_t pos = emptyCells[currCellPos];
+        const uint8_t lin = pos / Board::NUM_COLS;
+        const uint8_t col = pos % Board::NUM_COLS;
+        const uint8_t sec = lin / 3 * 3 + col / 3;
+        if (values[pos] != 0) {
+            // We're backtracking - the current value is taken off before
+            // trying the next candidate value.
+            const uint16_t mask =
+                static_cast<uint16_t>(~(1U << (values[pos] - 1U)));
+            lineMasks[lin] &= mask;
+            colMasks[col] &= mask;
+            secMasks[sec] &= mask;
+            values[pos] = 0;
+        }
+
+        const uint16_t used = lineMasks[lin] | colMasks[col] | secMasks[sec];
+        uint8_t candidatesIdx = nextCandidates[currCellPos];
+        while (candidatesIdx < Board::MAX_VAL &&
+               (used & (1U << (_candidates[candidatesIdx] - 1U))) != 0) {
+            // Try the next value in the cell.
+            candidatesIdx++;
+        }
+        if (candidatesIdx < Board::MAX_VAL) {
+            const uint8_t value = _candidates[candidatesIdx];
+            const uint16_t bit = static_cast<uint16_t>(1U << (value - 1U));
+            lineMasks[lin] |= bit;
+            colMasks[col] |= bit;
+            secMasks[sec] |= bit;
+            values[pos] = value;
+            nextCandidates[currCellPos] = candidatesIdx + 1;
+            currCellPos++;
+            if (counting()) {
+                _stats->nodes++;
+                _stats->maxDepth = max(_stats->maxDepth,
+                                       static_cast<uint32_t>(currCellPos));
+            }
+            if (currCellPos < numEmptyCells) {
+                nextCandidates[currCellPos] = 0;
+            }
+        } else if (currCellPos > 0) {
+            // No value left for the cell - have to roll back to the previous
+            // cell.
+            currCellPos--;
+            if (counting()) {
+                _stats->backtracks++;
+            }
+        } else {
+            boardUnsolvable = true;
+        }
+        if (onProgress != nullptr &&
+            !onProgress(static_cast<double>(currCellPos) /
+                        static_cast<double>(numEmptyCells) * 100.0)) {
+            return 0;
+        }
+    }
+    if (boardUnsolvable) {
+        return 0;
+    }
+    onSolution(Board::fromValues(values));
+    return 1;
+}
+
+void BacktrackingEngine::setCandidateOrder(const uint8_t *candidates) {
+    copy(candidates, candidates + Board::MAX_VAL, _candidates);
+}
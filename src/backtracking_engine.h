@@ -0,0 +1,41 @@
+#ifndef BACKTRACKING_ENGINE_H
+#define BACKTRACKING_ENGINE_H
+
+#include <cstdint>
+
+#include "board.h"
+#include "search_engine.h"
+
+namespace sudoku {
+
+/**
+ * @brief Solving engine that fills the blank positions of a board in
+ * line-major order, trying the values of each position in a given candidate
+ * order and backtracking on dead ends.
+ *
+ * The solution found depends only on the board and on the candidate order,
+ * which makes the engine suitable for generating reproducible random boards.
+ * The values placed in each line, column and section are kept as bit masks,
+ * so checking whether a value fits in a position takes constant time.
+ */
+class BacktrackingEngine : public SearchEngine {
+   public:
+    static const std::uint8_t CAPABILITIES = FirstSolution | CandidateOrder;
+
+    std::uint8_t capabilities() const noexcept override {
+        return CAPABILITIES;
+    }
+
+    unsigned search(const Board &board, const SolutionCallback &onSolution,
+                    const ProgressCallback &onProgress) override;
+
+    void setCandidateOrder(const std::uint8_t *candidates) override;
+
+   private:
+    // Values in the order they are tried - ascending by default.
+    std::uint8_t _candidates[Board::MAX_VAL]{1, 2, 3, 4, 5, 6, 7, 8, 9};
+};
+
+}  // namespace sudoku
+
+#endif
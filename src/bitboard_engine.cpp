@@ -0,0 +1,373 @@
+#include "bitboard_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include "board.h"
+#include "candidate_set.h"
+#include "unit_tables.h"
+
+using namespace std;
+using namespace sudoku;
+
+namespace {
+
+const uint16_t ALL_VALUES = CandidateSet::ALL_MASK;
+
+constexpr uint16_t valueBit(uint8_t value) noexcept {
+    return static_cast<uint16_t>(1U << (value - 1U));
+}
+
+}  // namespace
+
+template <bool CountLeaves, typename SolutionVisitor,
+          typename ProgressVisitor>
+uint64_t BitboardEngine::explore(const Board &board,
+                                 SolutionVisitor &&onSolution,
+                                 ProgressVisitor &&onProgress) {
+    const bool consistent = load(board) && propagate();
+    if (counting()) {
+        // Every change but the ones of the positions assigned takes off
+        // candidates.
+        _stats->eliminations += _numChanges - _numAssigned;
+    }
+    if (!consistent) {
+        return 0;
+    }
+    if (_numBlanks == 0) {
+        onSolution(1);
+        return 1;
+    }
+    uint64_t numCompletions = 0;
+    if (CountLeaves && countCompletions(numCompletions)) {
+        if (numCompletions > 0) {
+            onSolution(numCompletions);
+        }
+        return numCompletions;
+    }
+
+    uint64_t numSolutions = 0;
+    enterFrame(0);
+    const auto numRootBranches =
+        static_cast<double>(CandidateSet(_frames[0].remaining).size());
+    double progressPercent = 0.0;
+    int level = 0;
+    while (level >= 0) {
+        Frame &frame = _frames[level];
+        // Restores the state the frame was entered with.
+        undo(frame.numChanges, frame.numAssigned);
+        if (frame.remaining == 0) {
+            // All the candidates of the position have been tried.
+            level--;
+            continue;
+        }
+        CandidateSet remaining(frame.remaining);
+        const uint8_t value = remaining.popLowest();
+        frame.remaining = remaining.mask();
+        if (level == 0) {
+            // A rough approximation based on the branches already taken at
+            // the initial search node.
+            progressPercent =
+                (numRootBranches - static_cast<double>(remaining.size())) /
+                numRootBranches * 100.0;
+        }
+        if (!onProgress(progressPercent)) {
+            break;
+        }
+
+        const uint16_t numChanges = _numChanges;
+        const uint8_t numAssigned = _numAssigned;
+        const bool deadEnd = !assign(frame.pos, value) || !propagate();
+        if (counting()) {
+            countNode(level, numChanges, numAssigned, deadEnd);
+        }
+        if (deadEnd) {
+            // Try the next candidate.
+            continue;
+        }
+        if (_numBlanks == 0) {
+            numSolutions++;
+            if (!onSolution(1)) {
+                break;
+            }
+            continue;
+        }
+        if (CountLeaves && countCompletions(numCompletions)) {
+            numSolutions += numCompletions;
+            if (numCompletions > 0 && !onSolution(numCompletions)) {
+                break;
+            }
+            continue;
+        }
+        level++;
+        enterFrame(static_cast<uint8_t>(level));
+    }
+    return numSolutions;
+}
+
+unsigned BitboardEngine::search(const Board &board,
+                                const SolutionCallback &onSolution,
+                                const ProgressCallback &onProgress) {
+    return static_cast<unsigned>(explore<false>(
+        board,
+        [this, &onSolution](uint64_t) {
+            return onSolution(Board::fromValues(_values));
+        },
+        [&onProgress](double progressPercent) {
+            return onProgress == nullptr || onProgress(progressPercent);
+        }));
+}
+
+uint64_t BitboardEngine::count(const Board &board, uint64_t limit,
+                               uint8_t *solution,
+                               const atomic<bool> *cancelled) {
+    if (limit == 0) {
+        return 0;
+    }
+    uint64_t numSolutions = 0;
+    const auto notCancelled = [cancelled](double) {
+        return cancelled == nullptr || !cancelled->load();
+    };
+    if (solution != nullptr) {
+        // The first solution must be searched to have its values.
+        explore<false>(
+            board,
+            [this, &numSolutions, limit, solution](uint64_t) {
+                if (numSolutions == 0) {
+                    copy(_values, _values + Board::NUM_POS, solution);
+                }
+                return ++numSolutions < limit;
+            },
+            notCancelled);
+    } else {
+        explore<true>(
+            board,
+            [&numSolutions, limit](uint64_t numFound) {
+                numSolutions += numFound;
+                return numSolutions < limit;
+            },
+            notCancelled);
+    }
+    return min(numSolutions, limit);
+}
+
+bool BitboardEngine::countCompletions(uint64_t &numCompletions) const noexcept {
+    // Each line with blanks has two of them.
+    if (_numBlanks % 2 != 0 || _numBlanks > 2 * Board::NUM_ROWS) {
+        return false;
+    }
+    for (const uint16_t unitMask : _unitMasks) {
+        const uint8_t numPlaced = CandidateSet(unitMask).size();
+        if (numPlaced != Board::MAX_VAL && numPlaced != Board::MAX_VAL - 2) {
+            return false;
+        }
+    }
+
+    // Union-find of the blanks, linked by the units they share; each blank
+    // keeps the parity of its distance to the root of its set - the blanks
+    // of a unit take opposite values of the pair they share.
+    uint8_t parent[Board::NUM_POS];
+    uint8_t parity[Board::NUM_POS];
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        parent[pos] = pos;
+        parity[pos] = 0;
+    }
+    const auto findRoot = [&parent, &parity](uint8_t pos, uint8_t &posParity) {
+        posParity = 0;
+        while (parent[pos] != pos) {
+            posParity ^= parity[pos];
+            pos = parent[pos];
+        }
+        return pos;
+    };
+    uint8_t numSets = 0;
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        numSets += _values[pos] == 0 ? 1 : 0;
+    }
+    for (uint8_t unit = 0; unit < Board::NUM_UNITS; unit++) {
+        if (_unitMasks[unit] == ALL_VALUES) {
+            continue;
+        }
+        uint8_t blanks[2]{};
+        uint8_t numUnitBlanks = 0;
+        for (const uint8_t pos : UNIT_TABLES.units[unit]) {
+            if (_values[pos] == 0) {
+                blanks[numUnitBlanks++] = pos;
+            }
+        }
+        uint8_t firstParity = 0;
+        uint8_t secondParity = 0;
+        const uint8_t firstRoot = findRoot(blanks[0], firstParity);
+        const uint8_t secondRoot = findRoot(blanks[1], secondParity);
+        if (firstRoot == secondRoot) {
+            if (firstParity == secondParity) {
+                // An odd cycle - the blanks can't all alternate values.
+                numCompletions = 0;
+                return true;
+            }
+            continue;
+        }
+        parent[secondRoot] = firstRoot;
+        parity[secondRoot] =
+            static_cast<uint8_t>(firstParity ^ secondParity ^ 1U);
+        numSets--;
+    }
+    numCompletions = uint64_t{1} << numSets;
+    return true;
+}
+
+bool BitboardEngine::load(const Board &board) noexcept {
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        _candidates[pos] = ALL_VALUES;
+        _values[pos] = 0;
+    }
+    for (auto &unitMask : _unitMasks) {
+        unitMask = 0;
+    }
+    _numBlanks = Board::NUM_POS;
+    _numChanges = 0;
+    _numAssigned = 0;
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        const uint8_t value =
+            board.valueAt(pos / Board::NUM_COLS, pos % Board::NUM_COLS);
+        if (value != 0 && !assign(pos, value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BitboardEngine::assign(uint8_t pos, uint8_t value) noexcept {
+    const uint16_t bit = valueBit(value);
+    if ((_candidates[pos] & bit) == 0) {
+        return false;
+    }
+    _changes[_numChanges++] = {pos, _candidates[pos]};
+    _assigned[_numAssigned++] = pos;
+    _values[pos] = value;
+    _candidates[pos] = 0;
+    _numBlanks--;
+    for (const uint8_t unit : UNIT_TABLES.posUnits[pos]) {
+        _unitMasks[unit] |= bit;
+    }
+    for (const uint8_t peer : UNIT_TABLES.peers[pos]) {
+        uint16_t &peerCandidates = _candidates[peer];
+        if ((peerCandidates & bit) != 0) {
+            _changes[_numChanges++] = {peer, peerCandidates};
+            peerCandidates &= static_cast<uint16_t>(~bit);
+            if (peerCandidates == 0) {
+                // The peer is a blank with no candidate left.
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool BitboardEngine::propagate() noexcept {
+    bool changed = true;
+    while (changed && _numBlanks > 0) {
+        changed = false;
+
+        // Naked singles.
+        for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+            const CandidateSet candidates(_candidates[pos]);
+            if (candidates.size() == 1) {
+                if (!assign(pos, candidates.lowest())) {
+                    return false;
+                }
+                changed = true;
+            }
+        }
+
+        // Hidden singles - values that are candidates of exactly one position
+        // of a unit.
+        for (uint8_t unit = 0; unit < Board::NUM_UNITS; unit++) {
+            uint16_t once = 0;
+            uint16_t twice = 0;
+            for (const uint8_t pos : UNIT_TABLES.units[unit]) {
+                twice |= once & _candidates[pos];
+                once |= _candidates[pos];
+            }
+            if ((once | _unitMasks[unit]) != ALL_VALUES) {
+                // A value can't be placed anywhere in the unit.
+                return false;
+            }
+            CandidateSet singles(static_cast<uint16_t>(once & ~twice));
+            while (!singles.empty()) {
+                const uint8_t value = singles.popLowest();
+                uint8_t target = Board::NUM_POS;
+                for (const uint8_t pos : UNIT_TABLES.units[unit]) {
+                    if ((_candidates[pos] & valueBit(value)) != 0) {
+                        target = pos;
+                        break;
+                    }
+                }
+                // The position may have taken another hidden single of the
+                // unit in the meantime.
+                if (target == Board::NUM_POS || !assign(target, value)) {
+                    return false;
+                }
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
+
+void BitboardEngine::undo(uint16_t numChanges, uint8_t numAssigned) noexcept {
+    while (_numAssigned > numAssigned) {
+        const uint8_t pos = _assigned[--_numAssigned];
+        const uint16_t bit = valueBit(_values[pos]);
+        for (const uint8_t unit : UNIT_TABLES.posUnits[pos]) {
+            _unitMasks[unit] &= static_cast<uint16_t>(~bit);
+        }
+        _values[pos] = 0;
+        _numBlanks++;
+    }
+    // Changes are reverted newest first, so each position ends up with its
+    // oldest recorded candidates.
+    while (_numChanges > numChanges) {
+        const CandidatesChange &change = _changes[--_numChanges];
+        _candidates[change.pos] = change.candidates;
+    }
+}
+
+uint8_t BitboardEngine::selectPosition() const noexcept {
+    uint8_t selected = 0;
+    uint8_t minSize = Board::MAX_VAL + 1;
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        if (_candidates[pos] == 0) {
+            continue;
+        }
+        const uint8_t size = CandidateSet(_candidates[pos]).size();
+        if (size < minSize) {
+            selected = pos;
+            minSize = size;
+            if (size == 2) {
+                // Propagated states have no position with fewer candidates.
+                break;
+            }
+        }
+    }
+    return selected;
+}
+
+void BitboardEngine::countNode(int level, uint16_t numChanges,
+                               uint8_t numAssigned, bool deadEnd) noexcept {
+    _stats->nodes++;
+    _stats->backtracks += deadEnd ? 1 : 0;
+    _stats->maxDepth =
+        max(_stats->maxDepth, static_cast<uint32_t>(level + 1));
+    _stats->eliminations +=
+        (_numChanges - numChanges) - (_numAssigned - numAssigned);
+}
+
+void BitboardEngine::enterFrame(uint8_t level) noexcept {
+    Frame &frame = _frames[level];
+    frame.pos = selectPosition();
+    frame.remaining = _candidates[frame.pos];
+    frame.numChanges = _numChanges;
+    frame.numAssigned = _numAssigned;
+}
@@ -0,0 +1,131 @@
+#ifndef BITBOARD_ENGINE_H
+#define BITBOARD_ENGINE_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "board.h"
+#include "search_engine.h"
+
+namespace sudoku {
+
+/**
+ * @brief Solving engine that keeps the candidates of every position of a 9x9
+ * board as a bit mask.
+ *
+ * After every assignment naked singles (positions with a single candidate)
+ * and hidden singles (values with a single possible position in a unit) are
+ * propagated until a fixpoint is reached; the search then branches on the
+ * blank position with the fewest candidates. The search is iterative: a
+ * single state is modified in place and each of the at most 81 frames of the
+ * search stack only keeps its position, the candidates yet to be tried and
+ * how far to unwind the undo trails. Searching makes no allocations.
+ */
+class BitboardEngine : public SearchEngine {
+   public:
+    static const std::uint8_t CAPABILITIES =
+        FirstSolution | Counting | Enumeration;
+
+    std::uint8_t capabilities() const noexcept override {
+        return CAPABILITIES;
+    }
+
+    unsigned search(const Board &board, const SolutionCallback &onSolution,
+                    const ProgressCallback &onProgress) override;
+
+    std::uint64_t count(const Board &board, std::uint64_t limit,
+                        std::uint8_t *solution,
+                        const std::atomic<bool> *cancelled) override;
+
+   private:
+    // Each change of the candidates of a position removes at least one
+    // candidate, so a search path can't make more changes than this.
+    static const std::uint16_t MAX_CHANGES = Board::NUM_POS * Board::MAX_VAL;
+
+    struct CandidatesChange {
+        std::uint8_t pos;
+        // Candidates of the position before the change.
+        std::uint16_t candidates;
+    };
+
+    struct Frame {
+        // Position being branched on and its candidates yet to be tried.
+        std::uint8_t pos;
+        std::uint16_t remaining;
+        // Sizes of the undo trails when the frame was entered.
+        std::uint16_t numChanges;
+        std::uint8_t numAssigned;
+    };
+
+    /**
+     * @brief The search loop shared by search and count.
+     *
+     * @tparam CountLeaves whether the states whose completions can be counted
+     * in closed form are counted instead of searched - their solutions are
+     * then never set in _values.
+     * @param onSolution called with the number of solutions found - 1, with
+     * the solution in _values, unless counted in closed form; returning false
+     * stops the search.
+     * @param onProgress called with the progress of the search whenever the
+     * search branches; returning false stops the search.
+     * @return the number of solutions found.
+     */
+    template <bool CountLeaves, typename SolutionVisitor,
+              typename ProgressVisitor>
+    std::uint64_t explore(const Board &board, SolutionVisitor &&onSolution,
+                          ProgressVisitor &&onProgress);
+
+    /**
+     * @brief Counts the completions of a propagated state in closed form,
+     * when every unit has either no blank or two blanks left.
+     *
+     * Each of those units misses two values which are the candidates of both
+     * its blanks, so a completion only needs the two blanks of each unit to
+     * differ. Blanks linked by units form chains and cycles that have two
+     * completions each, or none if a cycle has an odd length.
+     *
+     * @param numCompletions receives the number of completions.
+     * @return whether the state could be counted in closed form.
+     */
+    bool countCompletions(std::uint64_t &numCompletions) const noexcept;
+
+    bool load(const Board &board) noexcept;
+
+    bool assign(std::uint8_t pos, std::uint8_t value) noexcept;
+
+    bool propagate() noexcept;
+
+    void undo(std::uint16_t numChanges, std::uint8_t numAssigned) noexcept;
+
+    std::uint8_t selectPosition() const noexcept;
+
+    void enterFrame(std::uint8_t level) noexcept;
+
+    /**
+     * @brief Counts a value tried at a given search level in the statistics,
+     * with the eliminations made since the undo trails had the given sizes.
+     */
+    void countNode(int level, std::uint16_t numChanges,
+                   std::uint8_t numAssigned, bool deadEnd) noexcept;
+
+    // Candidates of each position - 0 for filled positions.
+    std::uint16_t _candidates[Board::NUM_POS]{};
+    std::uint8_t _values[Board::NUM_POS]{};
+    // Values already placed in each unit.
+    std::uint16_t _unitMasks[Board::NUM_UNITS]{};
+    std::uint8_t _numBlanks{0};
+
+    // Undo trails - the candidates changes and the positions assigned along
+    // the current search path.
+    CandidatesChange _changes[MAX_CHANGES]{};
+    std::uint16_t _numChanges{0};
+    std::uint8_t _assigned[Board::NUM_POS]{};
+    std::uint8_t _numAssigned{0};
+
+    // One frame per search level - each level fills at least one position.
+    Frame _frames[Board::NUM_POS]{};
+};
+
+}  // namespace sudoku
+
+#endif
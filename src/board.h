@@ -1,12 +1,22 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <set>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "candidate_set.h"
+
 namespace sudoku {
 
 enum class SetValueResult : std::uint8_t {
@@ -16,41 +26,111 @@ enum class SetValueResult : std::uint8_t {
 };
 
 /**
- * @brief A 9x9 Sudoku board.
+ * @brief A Sudoku board made of sections with BoxRows lines and BoxCols
+ * columns - the board has BoxRows * BoxCols lines, columns, sections and
+ * values.
+ *
+ * The width of the unit masks and of the position counters are chosen at
+ * compile time from the board dimensions; values are always stored one per
+ * byte. Board, the 9x9 board, is the BasicBoard<3, 3> specialization;
+ * BasicBoard<2, 2>, BasicBoard<2, 3>, BasicBoard<4, 4> and BasicBoard<5, 5>
+ * are the 4x4, 6x6, 16x16 and 25x25 boards.
  */
-class Board {
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+class BasicBoard {
+    static_assert(BoxRows > 0 && BoxCols > 0 && BoxRows * BoxCols <= 32,
+                  "A board can have at most 32 values");
+
    public:
-    Board() = default;
+    // Type of the masks with one bit per value.
+    using MaskType = std::conditional_t<(BoxRows * BoxCols <= 16),
+                                        std::uint16_t, std::uint32_t>;
+
+    using CandidateSetType = BasicCandidateSet<MaskType, BoxRows * BoxCols>;
+
+    // Type wide enough to index or count all the positions of the board.
+    using PosType =
+        std::conditional_t<(BoxRows * BoxCols * BoxRows * BoxCols <= UINT8_MAX),
+                           std::uint8_t, std::uint16_t>;
+
+    static constexpr std::uint8_t BOX_ROWS = BoxRows;
+    static constexpr std::uint8_t BOX_COLS = BoxCols;
+    static constexpr std::uint8_t NUM_ROWS = BoxRows * BoxCols;
+    static constexpr std::uint8_t NUM_COLS = BoxRows * BoxCols;
+    static constexpr PosType NUM_POS = NUM_ROWS * NUM_COLS;
+    static constexpr std::uint8_t NUM_SECS = BoxRows * BoxCols;
+    static constexpr std::uint8_t NUM_UNITS = NUM_ROWS + NUM_COLS + NUM_SECS;
+    static constexpr std::uint8_t MIN_VAL = 1;
+    static constexpr std::uint8_t MAX_VAL = BoxRows * BoxCols;
 
-    explicit Board(const std::vector<std::uint8_t> &values) noexcept;
+    constexpr BasicBoard() noexcept = default;
 
-    Board(const Board &board);
+    explicit BasicBoard(const std::vector<std::uint8_t> &values) noexcept;
 
-    static const uint8_t NUM_ROWS = 9;
-    static const uint8_t NUM_COLS = 9;
-    static const uint8_t NUM_POS = NUM_ROWS * NUM_COLS;
-    static const uint8_t MIN_VAL = 1;
-    static const uint8_t MAX_VAL = 9;
+    /**
+     * @brief Creates a board from its values in line-major order.
+     *
+     * Unlike the vector based constructor, this one can be evaluated at
+     * compile time - puzzle tables can be declared constexpr and checked with
+     * static_assert. The array size is a template parameter only so that a
+     * braced list of values keeps selecting the vector based constructor;
+     * arrays with other than NUM_POS values are rejected at compile time.
+     */
+    template <std::size_t N>
+    constexpr explicit BasicBoard(
+        const std::array<std::uint8_t, N> &values) noexcept;
+
+    constexpr BasicBoard(const BasicBoard &board) = default;
+
+    /**
+     * @brief Creates a board from a string with one character per position in
+     * line-major order, without allocating.
+     *
+     * '0' and '.' are blanks, '1' to '9' are the values from 1 to 9 and the
+     * letters 'A' to 'Z' (in any case) are the values from 10 to 35. Any other
+     * character is read as an out-of-range value, so the returned board is
+     * invalid. Positions beyond the end of a shorter string are left blank and
+     * characters beyond NUM_POS are ignored.
+     */
+    static constexpr BasicBoard fromString(std::string_view text) noexcept;
+
+    /**
+     * @brief Creates a board from a raw buffer with exactly NUM_POS values in
+     * line-major order, without allocating.
+     */
+    static constexpr BasicBoard fromValues(const std::uint8_t *values) noexcept;
+
+    /**
+     * @brief Writes the board as NUM_POS characters in line-major order - the
+     * format read by fromString, with '0' for blanks. No terminating null
+     * character is written.
+     *
+     * @param buffer the destination, with room for at least NUM_POS
+     * characters.
+     * @return a pointer just past the last written character.
+     */
+    constexpr char *toChars(char *buffer) const noexcept;
 
     /**
      * Retrieves the value at a given (line, column) coordinate of the
      * board.
      *
-     * @param line the line number (from 0 to 8).
-     * @param column the column number (from 0 to 8).
+     * @param line the line number (from 0 to NUM_ROWS - 1).
+     * @param column the column number (from 0 to NUM_COLS - 1).
      * @return the value at position (line, column) of the board. If the
-     * position is filled, the value will be a number from 1 to 9. If the
+     * position is filled, the value will be a number from 1 to MAX_VAL. If the
      * position is empty, the value will be 0.
      */
-    std::uint8_t valueAt(std::uint8_t line, std::uint8_t column) const noexcept;
+    constexpr std::uint8_t valueAt(std::uint8_t line,
+                                   std::uint8_t column) const noexcept;
 
     /**
      * @brief Sets the value at a given (line, column) coordinate of the board.
      *
-     * @param line the line number (from 0 to 8).
-     * @param column the column number (from 0 to 8).
+     * @param line the line number (from 0 to NUM_ROWS - 1).
+     * @param column the column number (from 0 to NUM_COLS - 1).
      * @param the value to be set at position (line, column) of the board. Can
-     * be a value from 0 to 9 - 0 meaning empty.
+     * be a value from 0 to MAX_VAL - 0 meaning empty.
      * @return a SetValueResult indicating the result of the operation. If
      * the return is not SetValueResult::NO_ERROR, the board won't be changed.
      */
@@ -69,6 +149,17 @@ class Board {
     std::set<std::uint8_t> getPossibleValues(std::uint8_t line,
                                              std::uint8_t column) const;
 
+    /**
+     * @brief Allocation free version of getPossibleValues.
+     *
+     * @param line the line coordinate of the position to be evaluated.
+     * @param column the column coordinate of the position to be evaluated.
+     * @return the set of possible values for the board position - if the given
+     * position is not empty, an empty set is returned.
+     */
+    CandidateSetType getCandidates(std::uint8_t line,
+                                   std::uint8_t column) const noexcept;
+
     /**
      * @brief Clears the board by assigning the value 0 to all its positions.
      */
@@ -78,11 +169,11 @@ class Board {
      * @brief Checks if the board is currently valid.
      *
      * @return true if none of the values in the board violates the Sudoku
-     * non-repetition rules  across a line, a column or a 3x3 section and if all
-     * the values are in the appropriate range (between 0 and 9  - 0 being the
-     * value for empty positions).
+     * non-repetition rules  across a line, a column or a section and if all
+     * the values are in the appropriate range (between 0 and MAX_VAL - 0 being
+     * the value for empty positions).
      */
-    bool isValid() const;
+    constexpr bool isValid() const noexcept { return _conflicts == 0; }
 
     /**
      * @brief Returns the board positions that contains invalid values - either
@@ -105,7 +196,7 @@ class Board {
      *
      * @return number of blank positions in the board.
      */
-    uint8_t blankPositionCount() const noexcept;
+    constexpr PosType blankPositionCount() const noexcept;
 
     /**
      * @brief Returns the blank positions in the board.
@@ -119,32 +210,510 @@ class Board {
      * Returns true if a board has no blank position and is valid -
      * in other words, the board corresponds to a solved puzzle.
      */
-    bool isComplete() const;
+    constexpr bool isComplete() const noexcept {
+        return blankPositionCount() == 0 && isValid();
+    }
 
-    bool operator==(const Board &board) const noexcept;
+    /**
+     * @brief Returns the Zobrist key of the board - the XOR of one 64-bit key
+     * per non-blank (position, value) pair. The key is updated incrementally
+     * by every change to the board.
+     */
+    std::uint64_t hash() const noexcept { return _hashKey; }
+
+    bool operator==(const BasicBoard &board) const noexcept;
 
-    Board &operator=(const Board &board) noexcept;
+    bool operator!=(const BasicBoard &board) const noexcept {
+        return !(*this == board);
+    }
+
+    BasicBoard &operator=(const BasicBoard &board) noexcept = default;
 
    private:
-    // clang-format off
-    std::uint8_t _values[NUM_ROWS][NUM_COLS]{
-        {0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {0, 0, 0, 0, 0, 0, 0, 0, 0}};
-    // clang-format on
-
-    std::vector<std::pair<std::uint8_t, std::uint8_t>> findInvalidPositions(
-        bool pair1) const;
+    friend class PackedBoard;
+
+    // Type wide enough to count all the units and positions of the board.
+    using ConflictCount =
+        std::conditional_t<(NUM_UNITS + NUM_POS <= UINT8_MAX), std::uint8_t,
+                           std::uint16_t>;
+
+    std::uint8_t _values[NUM_ROWS][NUM_COLS]{};
+
+    // Occupancy masks for the units of the board - the lines come first,
+    // followed by the columns and the sections. Bit (v - 1) of a mask is set
+    // when value v is present in the unit.
+    MaskType _unitMasks[NUM_UNITS]{};
+
+    // Number of positions filled with an in-range value in each unit. A unit
+    // has a repetition whenever its count differs from its mask population.
+    std::uint8_t _unitCounts[NUM_UNITS]{};
+
+    // Number of units with repeated values plus number of positions with
+    // out-of-range values - the board is valid when this is 0.
+    ConflictCount _conflicts{0};
+
+    // Zobrist key of the board values.
+    std::uint64_t _hashKey{0};
+
+    static constexpr bool isInRange(std::uint8_t value) noexcept {
+        return value >= MIN_VAL && value <= MAX_VAL;
+    }
+
+    static constexpr MaskType valueBit(std::uint8_t value) noexcept {
+        return static_cast<MaskType>(1U << (value - 1U));
+    }
+
+    // Value of a character of the fromString format; characters that are
+    // neither blanks nor values are mapped to an out-of-range value.
+    static constexpr std::uint8_t charToValue(char chr) noexcept {
+        const auto code = static_cast<std::uint8_t>(chr);
+        const auto letter = static_cast<std::uint8_t>(code | 0x20U);
+        if (code == '.') {
+            return 0;
+        }
+        if (code >= '0' && code <= '9') {
+            return static_cast<std::uint8_t>(code - '0');
+        }
+        if (letter >= 'a' && letter <= 'z') {
+            return static_cast<std::uint8_t>(letter - 'a' + 10);
+        }
+        return UINT8_MAX;
+    }
+
+    // Character of a value in the fromString format; values that cannot be
+    // represented are written as '?', which reads back as out-of-range.
+    static constexpr char valueToChar(std::uint8_t value) noexcept {
+        if (value <= 9) {
+            return static_cast<char>('0' + value);
+        }
+        if (value <= 35) {
+            return static_cast<char>('A' + value - 10);
+        }
+        return '?';
+    }
+
+    static constexpr std::uint64_t zobristKey(std::uint8_t line,
+                                              std::uint8_t column,
+                                              std::uint8_t value) noexcept;
+
+    static constexpr std::uint8_t unitOf(std::uint8_t line,
+                                         std::uint8_t column,
+                                         std::uint8_t unitType) noexcept;
+
+    constexpr bool isUnitConsistent(std::uint8_t unit) const noexcept {
+        return CandidateSetType(_unitMasks[unit]).size() == _unitCounts[unit];
+    }
+
+    void rebuildUnitMask(std::uint8_t unit) noexcept;
+
+    constexpr void rebuildUnits() noexcept;
+
+    void updateUnits(std::uint8_t line, std::uint8_t column,
+                     std::uint8_t oldValue, std::uint8_t newValue) noexcept;
+
+    void findRepeatedValues(MaskType repeatedMasks[NUM_UNITS]) const noexcept;
 };
 
+/**
+ * @brief A 9x9 Sudoku board.
+ */
+using Board = BasicBoard<3, 3>;
+
+// The 9x9 board is instantiated once, in board.cpp.
+extern template class BasicBoard<3, 3>;
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+BasicBoard<BoxRows, BoxCols>::BasicBoard(
+    const std::vector<std::uint8_t> &values) noexcept {
+    const std::size_t upperBound =
+        std::min(static_cast<std::size_t>(NUM_POS), values.size());
+    for (std::size_t i = 0; i < upperBound; i++) {
+        _values[i / NUM_COLS][i % NUM_COLS] = values[i];
+    }
+    rebuildUnits();
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+template <std::size_t N>
+constexpr BasicBoard<BoxRows, BoxCols>::BasicBoard(
+    const std::array<std::uint8_t, N> &values) noexcept {
+    static_assert(N == NUM_POS, "A board must have exactly NUM_POS values");
+    for (std::uint8_t lin = 0; lin < NUM_ROWS; lin++) {
+        for (std::uint8_t col = 0; col < NUM_COLS; col++) {
+            _values[lin][col] = values[lin * NUM_COLS + col];
+        }
+    }
+    rebuildUnits();
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+constexpr BasicBoard<BoxRows, BoxCols> BasicBoard<BoxRows, BoxCols>::fromString(
+    std::string_view text) noexcept {
+    // The conversion has no dependencies between positions, so the compiler
+    // is free to vectorize it.
+    BasicBoard board;
+    const std::size_t upperBound =
+        std::min(static_cast<std::size_t>(NUM_POS), text.size());
+    for (std::size_t i = 0; i < upperBound; i++) {
+        board._values[i / NUM_COLS][i % NUM_COLS] = charToValue(text[i]);
+    }
+    board.rebuildUnits();
+    return board;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+constexpr BasicBoard<BoxRows, BoxCols> BasicBoard<BoxRows, BoxCols>::fromValues(
+    const std::uint8_t *values) noexcept {
+    BasicBoard board;
+    for (PosType i = 0; i < NUM_POS; i++) {
+        board._values[i / NUM_COLS][i % NUM_COLS] = values[i];
+    }
+    board.rebuildUnits();
+    return board;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+constexpr char *BasicBoard<BoxRows, BoxCols>::toChars(
+    char *buffer) const noexcept {
+    for (std::uint8_t lin = 0; lin < NUM_ROWS; lin++) {
+        for (std::uint8_t col = 0; col < NUM_COLS; col++) {
+            *buffer++ = valueToChar(_values[lin][col]);
+        }
+    }
+    return buffer;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+constexpr std::uint8_t BasicBoard<BoxRows, BoxCols>::valueAt(
+    std::uint8_t line, std::uint8_t column) const noexcept {
+    if (line < NUM_ROWS && column < NUM_COLS) {
+        return _values[line][column];
+    }
+
+    return 0;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+constexpr typename BasicBoard<BoxRows, BoxCols>::PosType
+BasicBoard<BoxRows, BoxCols>::blankPositionCount() const noexcept {
+    PosType nBlanks = 0;
+
+    for (const auto &_row : _values) {
+        for (const auto &_value : _row) {
+            if (_value == 0) {
+                nBlanks++;
+            }
+        }
+    }
+
+    return nBlanks;
+}
+
+// Zobrist key of a value at a given position - the splitmix64 finalizer of
+// the (position, value) pair. Blanks have key 0, so the empty board hashes
+// to 0.
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+constexpr std::uint64_t BasicBoard<BoxRows, BoxCols>::zobristKey(
+    std::uint8_t line, std::uint8_t column, std::uint8_t value) noexcept {
+    if (value == 0) {
+        return 0;
+    }
+    std::uint64_t key =
+        ((static_cast<std::uint64_t>(line) * NUM_COLS + column) << 8U) | value;
+    key += 0x9E3779B97F4A7C15ULL;
+    key = (key ^ (key >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27U)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31U);
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+constexpr std::uint8_t BasicBoard<BoxRows, BoxCols>::unitOf(
+    std::uint8_t line, std::uint8_t column, std::uint8_t unitType) noexcept {
+    // Sections are numbered in line-major order; there are BoxRows sections
+    // across the width of the board.
+    switch (unitType) {
+        case 0:
+            return line;
+        case 1:
+            return static_cast<std::uint8_t>(NUM_ROWS + column);
+        default:
+            return static_cast<std::uint8_t>(NUM_ROWS + NUM_COLS +
+                                             line / BoxRows * BoxRows +
+                                             column / BoxCols);
+    }
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+constexpr void BasicBoard<BoxRows, BoxCols>::rebuildUnits() noexcept {
+    for (std::uint8_t unit = 0; unit < NUM_UNITS; unit++) {
+        _unitMasks[unit] = 0;
+        _unitCounts[unit] = 0;
+    }
+    _conflicts = 0;
+    _hashKey = 0;
+    for (std::uint8_t lin = 0; lin < NUM_ROWS; lin++) {
+        for (std::uint8_t col = 0; col < NUM_COLS; col++) {
+            const std::uint8_t val = _values[lin][col];
+            _hashKey ^= zobristKey(lin, col, val);
+            if (val > MAX_VAL) {
+                _conflicts++;
+            } else if (val != 0) {
+                for (std::uint8_t unitType = 0; unitType < 3; unitType++) {
+                    const std::uint8_t unit = unitOf(lin, col, unitType);
+                    _unitMasks[unit] |= valueBit(val);
+                    _unitCounts[unit]++;
+                }
+            }
+        }
+    }
+    for (std::uint8_t unit = 0; unit < NUM_UNITS; unit++) {
+        if (!isUnitConsistent(unit)) {
+            _conflicts++;
+        }
+    }
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+std::vector<std::pair<std::uint8_t, std::uint8_t>>
+BasicBoard<BoxRows, BoxCols>::getBlankPositions() const {
+    std::vector<std::pair<std::uint8_t, std::uint8_t>> blanks;
+
+    for (std::uint8_t lin = 0; lin < NUM_ROWS; lin++) {
+        for (std::uint8_t col = 0; col < NUM_COLS; col++) {
+            if (_values[lin][col] == 0) {
+                blanks.emplace_back(lin, col);
+            }
+        }
+    }
+
+    return blanks;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+SetValueResult BasicBoard<BoxRows, BoxCols>::setValueAt(std::uint8_t line,
+                                                        std::uint8_t column,
+                                                        std::uint8_t value) {
+    if (value > MAX_VAL) {
+        return SetValueResult::InvalidValue;
+    }
+
+    // Sets the value in place - only the line, the column and the section of
+    // the position are affected, so checking the board validity afterwards
+    // is O(1).
+    const std::uint8_t oldValue = _values[line][column];
+    updateUnits(line, column, oldValue, value);
+    SetValueResult res = SetValueResult::NoError;
+    if (!isValid()) {
+        // Value invalidates the board; restores the previous value.
+        updateUnits(line, column, value, oldValue);
+        res = SetValueResult::ValueInvalidatesBoard;
+    }
+    return res;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+std::set<std::uint8_t> BasicBoard<BoxRows, BoxCols>::getPossibleValues(
+    std::uint8_t line, std::uint8_t column) const {
+    const CandidateSetType candidates = getCandidates(line, column);
+    return std::set<std::uint8_t>(candidates.begin(), candidates.end());
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+typename BasicBoard<BoxRows, BoxCols>::CandidateSetType
+BasicBoard<BoxRows, BoxCols>::getCandidates(
+    std::uint8_t line, std::uint8_t column) const noexcept {
+    if (_values[line][column] != 0) {
+        return CandidateSetType();
+    }
+    // Position is empty - the possible values are the ones absent from the
+    // line, the column and the section of the position.
+    return ~CandidateSetType(
+        static_cast<MaskType>(_unitMasks[unitOf(line, column, 0)] |
+                              _unitMasks[unitOf(line, column, 1)] |
+                              _unitMasks[unitOf(line, column, 2)]));
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+void BasicBoard<BoxRows, BoxCols>::clear() noexcept {
+    for (auto &_valuesInLine : _values) {
+        for (auto &_value : _valuesInLine) {
+            _value = 0;
+        }
+    }
+    for (std::uint8_t unit = 0; unit < NUM_UNITS; unit++) {
+        _unitMasks[unit] = 0;
+        _unitCounts[unit] = 0;
+    }
+    _conflicts = 0;
+    _hashKey = 0;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+std::vector<std::pair<std::uint8_t, std::uint8_t>>
+BasicBoard<BoxRows, BoxCols>::getInvalidPositions() const {
+    std::vector<std::pair<std::uint8_t, std::uint8_t>> invalidPositions;
+    if (isValid()) {
+        return invalidPositions;
+    }
+
+    MaskType repeatedMasks[NUM_UNITS];
+    findRepeatedValues(repeatedMasks);
+
+    // A position is invalid if its value is out of range or if its value is
+    // repeated in any of the units the position belongs to. Positions are
+    // visited in line-major order, so the result needs neither sorting nor
+    // deduplication.
+    for (std::uint8_t lin = 0; lin < NUM_ROWS; lin++) {
+        for (std::uint8_t col = 0; col < NUM_COLS; col++) {
+            const std::uint8_t val = _values[lin][col];
+            if (val == 0) {
+                continue;
+            }
+            const MaskType repeated = repeatedMasks[unitOf(lin, col, 0)] |
+                                      repeatedMasks[unitOf(lin, col, 1)] |
+                                      repeatedMasks[unitOf(lin, col, 2)];
+            if (!isInRange(val) || (repeated & valueBit(val)) != 0) {
+                invalidPositions.emplace_back(lin, col);
+            }
+        }
+    }
+
+    return invalidPositions;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+void BasicBoard<BoxRows, BoxCols>::findRepeatedValues(
+    MaskType repeatedMasks[NUM_UNITS]) const noexcept {
+    // Each value is one-hot encoded as a bit of a mask word; a value is
+    // repeated in a unit when its bit is found already set in the unit's
+    // "seen" accumulator. Out-of-range values encode to 0 and are ignored.
+    MaskType seenMasks[NUM_UNITS]{};
+    for (std::uint8_t unit = 0; unit < NUM_UNITS; unit++) {
+        repeatedMasks[unit] = 0;
+    }
+    for (std::uint8_t lin = 0; lin < NUM_ROWS; lin++) {
+        for (std::uint8_t col = 0; col < NUM_COLS; col++) {
+            const std::uint8_t val = _values[lin][col];
+            const MaskType oneHot = isInRange(val) ? valueBit(val) : 0;
+            for (std::uint8_t unitType = 0; unitType < 3; unitType++) {
+                const std::uint8_t unit = unitOf(lin, col, unitType);
+                repeatedMasks[unit] |= seenMasks[unit] & oneHot;
+                seenMasks[unit] |= oneHot;
+            }
+        }
+    }
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+bool BasicBoard<BoxRows, BoxCols>::isEmpty() const noexcept {
+    const std::uint8_t *values = &_values[0][0];
+    for (PosType i = 0; i < NUM_POS; i++) {
+        if (values[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+bool BasicBoard<BoxRows, BoxCols>::operator==(
+    const BasicBoard &board) const noexcept {
+    // Boards with different values almost always have different keys.
+    return _hashKey == board._hashKey &&
+           std::memcmp(_values, board._values, sizeof(_values)) == 0;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+void BasicBoard<BoxRows, BoxCols>::rebuildUnitMask(
+    std::uint8_t unit) noexcept {
+    MaskType mask = 0;
+    for (std::uint8_t i = 0; i < MAX_VAL; i++) {
+        std::uint8_t lin = 0;
+        std::uint8_t col = 0;
+        if (unit < NUM_ROWS) {
+            lin = unit;
+            col = i;
+        } else if (unit < NUM_ROWS + NUM_COLS) {
+            lin = i;
+            col = unit - NUM_ROWS;
+        } else {
+            const std::uint8_t sec = unit - NUM_ROWS - NUM_COLS;
+            lin = sec / BoxRows * BoxRows + i / BoxCols;
+            col = sec % BoxRows * BoxCols + i % BoxCols;
+        }
+        if (isInRange(_values[lin][col])) {
+            mask |= valueBit(_values[lin][col]);
+        }
+    }
+    _unitMasks[unit] = mask;
+}
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+void BasicBoard<BoxRows, BoxCols>::updateUnits(
+    std::uint8_t line, std::uint8_t column, std::uint8_t oldValue,
+    std::uint8_t newValue) noexcept {
+    // The position must already hold the new value in case a unit mask has to
+    // be rebuilt.
+    _values[line][column] = newValue;
+    _hashKey ^= zobristKey(line, column, oldValue) ^
+                zobristKey(line, column, newValue);
+    if (oldValue > MAX_VAL) {
+        _conflicts--;
+    }
+    if (newValue > MAX_VAL) {
+        _conflicts++;
+    }
+    for (std::uint8_t unitType = 0; unitType < 3; unitType++) {
+        const std::uint8_t unit = unitOf(line, column, unitType);
+        const bool wasConsistent = isUnitConsistent(unit);
+        if (isInRange(oldValue)) {
+            _unitCounts[unit]--;
+            if (wasConsistent) {
+                // The old value was its only occurrence in the unit.
+                _unitMasks[unit] &= static_cast<MaskType>(~valueBit(oldValue));
+            } else {
+                // The old value may still be present elsewhere in the unit.
+                rebuildUnitMask(unit);
+            }
+        }
+        if (isInRange(newValue)) {
+            _unitCounts[unit]++;
+            _unitMasks[unit] |= valueBit(newValue);
+        }
+        const bool isConsistent = isUnitConsistent(unit);
+        if (wasConsistent && !isConsistent) {
+            _conflicts++;
+        } else if (!wasConsistent && isConsistent) {
+            _conflicts--;
+        }
+    }
+}
+
 }  // namespace sudoku
 
-std::ostream &operator<<(std::ostream &ostr, const sudoku::Board &board);
+namespace std {
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+struct hash<sudoku::BasicBoard<BoxRows, BoxCols>> {
+    size_t operator()(
+        const sudoku::BasicBoard<BoxRows, BoxCols> &board) const noexcept {
+        return static_cast<size_t>(board.hash());
+    }
+};
+
+}  // namespace std
+
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+std::ostream &operator<<(std::ostream &ostr,
+                         const sudoku::BasicBoard<BoxRows, BoxCols> &board) {
+    using BoardType = sudoku::BasicBoard<BoxRows, BoxCols>;
+    for (std::uint8_t lin = 0; lin < BoardType::NUM_ROWS; lin++) {
+        for (std::uint8_t col = 0; col < BoardType::NUM_COLS; col++) {
+            ostr << static_cast<int>(board.valueAt(lin, col)) << " ";
+        }
+        ostr << std::endl;
+    }
+    return ostr;
+}
 
 #endif
@@ -0,0 +1,217 @@
+#ifndef CANDIDATE_SET_H
+#define CANDIDATE_SET_H
+
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace sudoku {
+
+/**
+ * @brief A set of Sudoku values (from 1 to NumValues) stored as a bit mask.
+ *
+ * Bit (v - 1) of the mask is set when value v belongs to the set. Being
+ * trivially copyable and allocation free, it is meant to be used in the hot
+ * paths of the solver instead of a std::set<std::uint8_t>.
+ *
+ * @tparam MaskType the unsigned integer type of the mask - must have at least
+ * NumValues bits.
+ * @tparam NumValues the number of values of the board (9 for a 9x9 board).
+ */
+template <typename MaskType, std::uint8_t NumValues>
+class BasicCandidateSet {
+    static_assert(std::is_unsigned<MaskType>::value &&
+                      sizeof(MaskType) * 8 >= NumValues &&
+                      sizeof(MaskType) <= sizeof(unsigned),
+                  "MaskType must be an unsigned type wide enough for the "
+                  "values");
+
+   public:
+    static constexpr MaskType ALL_MASK =
+        static_cast<MaskType>((1ULL << NumValues) - 1);
+
+    /**
+     * @brief Iterates over the values of a set in ascending order by
+     * repeatedly extracting the lowest set bit of a copy of the mask.
+     */
+    class Iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::uint8_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::uint8_t *;
+        using reference = std::uint8_t;
+
+        constexpr explicit Iterator(MaskType mask) noexcept
+            : _mask(mask) {}
+
+        constexpr std::uint8_t operator*() const noexcept {
+            return BasicCandidateSet(_mask).lowest();
+        }
+
+        constexpr Iterator &operator++() noexcept {
+            _mask &= static_cast<MaskType>(_mask - 1);
+            return *this;
+        }
+
+        constexpr Iterator operator++(int) noexcept {
+            Iterator prev(*this);
+            ++(*this);
+            return prev;
+        }
+
+        constexpr bool operator==(const Iterator &other) const noexcept {
+            return _mask == other._mask;
+        }
+
+        constexpr bool operator!=(const Iterator &other) const noexcept {
+            return _mask != other._mask;
+        }
+
+       private:
+        MaskType _mask;
+    };
+
+    constexpr BasicCandidateSet() noexcept = default;
+
+    constexpr explicit BasicCandidateSet(MaskType mask) noexcept
+        : _mask(static_cast<MaskType>(mask & ALL_MASK)) {}
+
+    /**
+     * Returns the set with all the values from 1 to NumValues.
+     */
+    static constexpr BasicCandidateSet all() noexcept {
+        return BasicCandidateSet(ALL_MASK);
+    }
+
+    constexpr MaskType mask() const noexcept { return _mask; }
+
+    constexpr bool empty() const noexcept { return _mask == 0; }
+
+    /**
+     * Returns the number of values in the set.
+     */
+    constexpr std::uint8_t size() const noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::uint8_t>(__builtin_popcount(_mask));
+#else
+        MaskType mask = _mask;
+        std::uint8_t nBits = 0;
+        while (mask != 0) {
+            mask &= static_cast<MaskType>(mask - 1);
+            nBits++;
+        }
+        return nBits;
+#endif
+    }
+
+    constexpr bool contains(std::uint8_t value) const noexcept {
+        return value >= 1 && value <= NumValues &&
+               (_mask & bitOf(value)) != 0;
+    }
+
+    /**
+     * Returns the smallest value in the set or 0 if the set is empty.
+     */
+    constexpr std::uint8_t lowest() const noexcept {
+        if (_mask == 0) {
+            return 0;
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::uint8_t>(__builtin_ctz(_mask) + 1);
+#else
+        std::uint8_t value = 1;
+        while ((_mask & bitOf(value)) == 0) {
+            value++;
+        }
+        return value;
+#endif
+    }
+
+    /**
+     * Removes the smallest value from the set and returns it - 0 is returned
+     * if the set is empty.
+     */
+    constexpr std::uint8_t popLowest() noexcept {
+        const std::uint8_t value = lowest();
+        _mask &= static_cast<MaskType>(_mask - 1);
+        return value;
+    }
+
+    constexpr void insert(std::uint8_t value) noexcept {
+        if (value >= 1 && value <= NumValues) {
+            _mask |= bitOf(value);
+        }
+    }
+
+    constexpr void erase(std::uint8_t value) noexcept {
+        if (value >= 1 && value <= NumValues) {
+            _mask &= static_cast<MaskType>(~bitOf(value));
+        }
+    }
+
+    constexpr Iterator begin() const noexcept { return Iterator(_mask); }
+
+    constexpr Iterator end() const noexcept { return Iterator(0); }
+
+    constexpr BasicCandidateSet operator|(
+        BasicCandidateSet other) const noexcept {
+        return BasicCandidateSet(static_cast<MaskType>(_mask | other._mask));
+    }
+
+    constexpr BasicCandidateSet operator&(
+        BasicCandidateSet other) const noexcept {
+        return BasicCandidateSet(static_cast<MaskType>(_mask & other._mask));
+    }
+
+    constexpr BasicCandidateSet operator-(
+        BasicCandidateSet other) const noexcept {
+        return BasicCandidateSet(static_cast<MaskType>(_mask & ~other._mask));
+    }
+
+    constexpr BasicCandidateSet operator~() const noexcept {
+        return BasicCandidateSet(static_cast<MaskType>(~_mask));
+    }
+
+    constexpr BasicCandidateSet &operator|=(
+        BasicCandidateSet other) noexcept {
+        _mask |= other._mask;
+        return *this;
+    }
+
+    constexpr BasicCandidateSet &operator&=(
+        BasicCandidateSet other) noexcept {
+        _mask &= other._mask;
+        return *this;
+    }
+
+    constexpr BasicCandidateSet &operator-=(
+        BasicCandidateSet other) noexcept {
+        _mask &= static_cast<MaskType>(~other._mask);
+        return *this;
+    }
+
+    constexpr bool operator==(BasicCandidateSet other) const noexcept {
+        return _mask == other._mask;
+    }
+
+    constexpr bool operator!=(BasicCandidateSet other) const noexcept {
+        return _mask != other._mask;
+    }
+
+   private:
+    static constexpr MaskType bitOf(std::uint8_t value) noexcept {
+        return static_cast<MaskType>(1U << (value - 1U));
+    }
+
+    MaskType _mask{0};
+};
+
+/**
+ * @brief The candidate set of a 9x9 board.
+ */
+using CandidateSet = BasicCandidateSet<std::uint16_t, 9>;
+
+}  // namespace sudoku
+
+#endif
@@ -0,0 +1,781 @@
+#pragma clang diagnostic push
+#pragma ide diagnostic ignored "misc-no-recursion"
+
+#include "canonical_form.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+#include "board.h"
+#include "candidate_set.h"
+
+using namespace std;
+using namespace sudoku;
+
+namespace {
+
+const uint8_t BAND_SIZE = 3;
+const uint8_t NUM_STACKS = Board::NUM_COLS / BAND_SIZE;
+const uint8_t NO_COLUMN = 0xFF;
+const uint8_t NO_STACK = 0xFF;
+// Key of a value without a label yet - greater than any label.
+const uint8_t FRESH_KEY = Board::MAX_VAL + 1;
+
+// Sets of source columns are bit masks, column c being bit c - the mask of
+// the CandidateSet of values c + 1. Sets of stacks are masks of 3 bits.
+inline uint16_t columnBit(uint8_t col) noexcept {
+    return static_cast<uint16_t>(1U << col);
+}
+
+inline uint8_t numColumns(uint16_t cols) noexcept {
+    return CandidateSet(cols).size();
+}
+
+inline uint8_t firstColumn(uint16_t cols) noexcept {
+    return static_cast<uint8_t>(CandidateSet(cols).lowest() - 1);
+}
+
+inline bool isSingle(uint8_t stacks) noexcept {
+    return CandidateSet(stacks).size() == 1;
+}
+
+/**
+ * What a branch of the search has fixed so far: the lines placed, the
+ * columns and the labels of the values.
+ *
+ * The columns are kept as ordered partitions, both of the stacks and of the
+ * columns inside each stack, whose cells hold stacks or columns whose order
+ * is still open. Every position of the canonical form compared so far has
+ * the same value for any order inside the cells, so a cell is only split
+ * when a line tells its stacks or columns apart, and the search never
+ * branches on what no line has told apart yet.
+ *
+ * The columns of a source stack are addressed by slots - 3 per stack, in the
+ * order they go to the canonical columns of the stack. A stack whose place
+ * is still open only ever had blanks after the first line, so its values are
+ * all from the first line.
+ *
+ * The label of a value of a placed stack is labelBase plus the canonical
+ * column of labelCol, the source column it was first seen at. Values first
+ * seen in a line at the columns of a cell take consecutive labels in the
+ * order of the columns, so their labels are only known once the cell is
+ * split.
+ */
+struct Branch {
+    // Source line at each canonical line placed so far.
+    uint8_t rowMap[Board::NUM_ROWS];
+    uint16_t usedRows;
+    // Source stack at each canonical stack - NO_STACK while its place is
+    // open.
+    uint8_t stackAt[NUM_STACKS];
+    // Canonical stack the cell of each source stack starts at.
+    uint8_t stackCellOf[NUM_STACKS];
+    // One past the last canonical stack of the cell starting at each
+    // canonical stack, and its source stacks.
+    uint8_t stackCellEnd[NUM_STACKS];
+    uint8_t stackCellStacks[NUM_STACKS];
+    // Slot the cell of each source column starts at.
+    uint8_t cellOf[Board::NUM_COLS];
+    // One past the last slot of the cell starting at each slot, and its
+    // source columns.
+    uint8_t cellEnd[Board::NUM_COLS];
+    uint16_t cellCols[Board::NUM_COLS];
+    uint8_t numCells;
+    uint8_t labelCol[Board::MAX_VAL + 1];
+    int8_t labelBase[Board::MAX_VAL + 1];
+    uint8_t nextLabel;
+    // Label of a value of the first line in each canonical stack, less the
+    // place of its column in the stack.
+    int8_t firstLineBase[NUM_STACKS];
+};
+
+inline uint8_t slotsStart(uint8_t stack) noexcept {
+    return static_cast<uint8_t>(stack * BAND_SIZE);
+}
+
+// Splits a set of source columns off the front of the cell starting at a
+// slot.
+void splitCell(Branch &branch, uint8_t start, uint16_t cols) noexcept {
+    const uint16_t rest = branch.cellCols[start] & ~cols;
+    if (rest == 0) {
+        return;
+    }
+    const auto restStart = static_cast<uint8_t>(start + numColumns(cols));
+    branch.cellEnd[restStart] = branch.cellEnd[start];
+    branch.cellCols[restStart] = rest;
+    branch.cellEnd[start] = restStart;
+    branch.cellCols[start] = cols;
+    branch.numCells++;
+    for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+        if ((rest & columnBit(col)) != 0) {
+            branch.cellOf[col] = restStart;
+        }
+    }
+}
+
+// Splits a set of source stacks off the front of the cell of stacks starting
+// at a canonical stack.
+void splitStackCell(Branch &branch, uint8_t start, uint8_t stacks) noexcept {
+    const auto rest =
+        static_cast<uint8_t>(branch.stackCellStacks[start] & ~stacks);
+    if (rest == 0) {
+        return;
+    }
+    const auto restStart =
+        static_cast<uint8_t>(start + CandidateSet(stacks).size());
+    branch.stackCellEnd[restStart] = branch.stackCellEnd[start];
+    branch.stackCellStacks[restStart] = rest;
+    branch.stackCellEnd[start] = restStart;
+    branch.stackCellStacks[start] = stacks;
+    for (uint8_t stack = 0; stack < NUM_STACKS; stack++) {
+        if ((rest & (1U << stack)) != 0) {
+            branch.stackCellOf[stack] = restStart;
+        }
+    }
+}
+
+// Places a source stack at the canonical stack its cell starts at, and the
+// last stack of the cell along with it.
+void placeStack(Branch &branch, uint8_t stack) noexcept {
+    const uint8_t canonStack = branch.stackCellOf[stack];
+    const auto rest = static_cast<uint8_t>(
+        branch.stackCellStacks[canonStack] & ~(1U << stack));
+    branch.stackAt[canonStack] = stack;
+    // The first line's values of the stack get their labels.
+    for (uint8_t val = Board::MIN_VAL; val <= Board::MAX_VAL; val++) {
+        if (branch.labelCol[val] != NO_COLUMN &&
+            branch.labelCol[val] / BAND_SIZE == stack) {
+            branch.labelBase[val] = static_cast<int8_t>(
+                branch.firstLineBase[canonStack] - slotsStart(canonStack));
+        }
+    }
+    splitStackCell(branch, canonStack, static_cast<uint8_t>(1U << stack));
+    if (isSingle(rest)) {
+        placeStack(branch, firstColumn(rest));
+    }
+}
+
+// The smallest value a source column can put at the canonical column the
+// cell starting at slot goes to: 0 for a blank, FRESH_KEY for a value
+// without label and, for a value whose label is still open, the label it
+// takes if its column goes first in its cell and its stack first in its
+// cell of stacks.
+uint8_t keyOf(const Branch &branch, uint8_t value, uint8_t col,
+              uint8_t slot) noexcept {
+    if (value == 0) {
+        return 0;
+    }
+    const uint8_t labelCol = branch.labelCol[value];
+    if (labelCol == NO_COLUMN) {
+        return FRESH_KEY;
+    }
+    const uint8_t stack = labelCol / BAND_SIZE;
+    uint8_t place = branch.cellOf[labelCol] - slotsStart(stack);
+    if (branch.cellOf[labelCol] == slot && labelCol != col) {
+        // Shares the cell with col, which goes first.
+        place++;
+    }
+    const uint8_t canonStack = branch.stackCellOf[stack];
+    if (branch.stackAt[canonStack] != stack) {
+        return static_cast<uint8_t>(branch.firstLineBase[canonStack] + place);
+    }
+    return static_cast<uint8_t>(branch.labelBase[value] +
+                                slotsStart(canonStack) + place);
+}
+
+// Places a source column at the front of the cell starting at slot, along
+// with the column and the stack that set the label of its value.
+void place(Branch &branch, uint8_t value, uint8_t col, uint8_t slot) noexcept {
+    splitCell(branch, slot, columnBit(col));
+    if (value != 0) {
+        const uint8_t labelCol = branch.labelCol[value];
+        splitCell(branch, branch.cellOf[labelCol], columnBit(labelCol));
+        const uint8_t stack = labelCol / BAND_SIZE;
+        if (branch.stackAt[branch.stackCellOf[stack]] != stack) {
+            placeStack(branch, stack);
+        }
+    }
+}
+
+// Branches kept by a line of the search before going down.
+const uint8_t MAX_LINE_BRANCHES = 16;
+
+struct LineBranches {
+    Branch branches[MAX_LINE_BRANCHES];
+    uint8_t numBranches{0};
+    // Version of the best form the branches match.
+    unsigned bestVersion{0};
+};
+
+/**
+ * Branch-and-bound search for the minlex form of a board.
+ *
+ * The search tree enumerates, in this order, the transposition, the line
+ * that goes first and then the remaining lines. The columns are ordered
+ * lazily, as the lines split the cells of stacks and columns: the first line
+ * puts the stacks with more blanks and, inside the stacks, the blanks first,
+ * and the value at each canonical position of the lines after it is the
+ * smallest the columns of its cell can put there. The search only branches
+ * on the stacks of a cell that has values in a line and on columns that tie
+ * on a label; once the columns and the labels are all fixed, the remaining
+ * lines are just sorted. Every position of the candidate form is compared
+ * with the best form found so far as soon as its value is known, so a branch
+ * is abandoned at the first position where it becomes greater than the best;
+ * and all the candidates for a line are compared before going down, so only
+ * the branches with the smallest line are searched further. Since positions
+ * are produced in line-major order and values are relabeled in order of
+ * first appearance, the comparison is exactly the lexicographic order of the
+ * relabeled boards.
+ */
+class Canonicalizer {
+   public:
+    explicit Canonicalizer(const Board &board) noexcept {
+        CandidateSet values;
+        for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+            for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+                const uint8_t val = board.valueAt(lin, col);
+                _grids[0][lin * Board::NUM_COLS + col] = val;
+                _grids[1][col * Board::NUM_COLS + lin] = val;
+                if (val != 0) {
+                    values.insert(val);
+                }
+            }
+        }
+        _numValues = values.size();
+    }
+
+    void run() noexcept {
+        // Only the lines with the smallest first line of all can go first.
+        uint8_t firstLineRanks[2][Board::NUM_ROWS];
+        uint8_t bestRank = 0;
+        for (uint8_t transp = 0; transp < 2; transp++) {
+            for (uint8_t row = 0; row < Board::NUM_ROWS; row++) {
+                firstLineRanks[transp][row] = firstLineRank(
+                    _grids[transp] + row * Board::NUM_COLS);
+                bestRank = max(bestRank, firstLineRanks[transp][row]);
+            }
+        }
+        for (uint8_t transp = 0; transp < 2; transp++) {
+            _grid = _grids[transp];
+            _transposed = transp == 1;
+            for (uint8_t row = 0; row < Board::NUM_ROWS; row++) {
+                if (firstLineRanks[transp][row] == bestRank) {
+                    searchFirstLine(row);
+                }
+            }
+        }
+    }
+
+    const uint8_t *best() const noexcept { return _best; }
+
+    const Transform &bestTransform() const noexcept { return _bestTransform; }
+
+   private:
+    // Compares the value of a candidate position with the best form. Returns
+    // false if the branch must be pruned.
+    bool accept(uint8_t pos, uint8_t value) noexcept {
+        if (pos >= _bestLen || value < _best[pos]) {
+            // New best prefix - positions after pos are unknown.
+            _best[pos] = value;
+            _bestLen = static_cast<uint8_t>(pos + 1);
+            _bestVersion++;
+            return true;
+        }
+        return value == _best[pos];
+    }
+
+    // Rank of a line as the first line - higher for a smaller first line.
+    // The first line has the blanks of the stacks with more blanks first,
+    // so it only depends on the blanks per stack.
+    static uint8_t firstLineRank(const uint8_t *values) noexcept {
+        uint8_t numBlanks[NUM_STACKS]{};
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            if (values[col] == 0) {
+                numBlanks[col / BAND_SIZE]++;
+            }
+        }
+        sort(begin(numBlanks), end(numBlanks), greater<>());
+        return static_cast<uint8_t>(numBlanks[0] << 4 | numBlanks[1] << 2 |
+                                    numBlanks[2]);
+    }
+
+    // Places a line first: the stacks with more blanks in the line go first,
+    // as do the blanks inside each stack.
+    void searchFirstLine(uint8_t row) noexcept {
+        const uint8_t *values = _grid + row * Board::NUM_COLS;
+        Branch branch{};
+        branch.rowMap[0] = row;
+        branch.usedRows = columnBit(row);
+        branch.nextLabel = 1;
+        branch.numCells = NUM_STACKS;
+        fill(begin(branch.labelCol), end(branch.labelCol), NO_COLUMN);
+        fill(begin(branch.stackAt), end(branch.stackAt), NO_STACK);
+        uint8_t numBlanks[NUM_STACKS]{};
+        for (uint8_t stack = 0; stack < NUM_STACKS; stack++) {
+            const uint8_t start = slotsStart(stack);
+            uint16_t blanks = 0;
+            for (uint8_t col = start; col < start + BAND_SIZE; col++) {
+                branch.cellOf[col] = start;
+                if (values[col] == 0) {
+                    blanks |= columnBit(col);
+                    numBlanks[stack]++;
+                }
+            }
+            branch.cellEnd[start] = start + BAND_SIZE;
+            branch.cellCols[start] = static_cast<uint16_t>(0x7U << start);
+            if (blanks != 0) {
+                splitCell(branch, start, blanks);
+            }
+        }
+
+        // Stacks with as many blanks tie - their order is left open.
+        uint8_t canonStack = 0;
+        for (int8_t count = BAND_SIZE; count >= 0; count--) {
+            uint8_t stacks = 0;
+            for (uint8_t stack = 0; stack < NUM_STACKS; stack++) {
+                if (numBlanks[stack] == count) {
+                    stacks = static_cast<uint8_t>(stacks | (1U << stack));
+                    branch.stackCellOf[stack] = canonStack;
+                }
+            }
+            if (stacks == 0) {
+                continue;
+            }
+            const uint8_t numStacks = CandidateSet(stacks).size();
+            branch.stackCellStacks[canonStack] = stacks;
+            branch.stackCellEnd[canonStack] =
+                static_cast<uint8_t>(canonStack + numStacks);
+            for (uint8_t i = 0; i < numStacks; i++, canonStack++) {
+                branch.firstLineBase[canonStack] =
+                    static_cast<int8_t>(branch.nextLabel - count);
+                for (uint8_t place = 0; place < BAND_SIZE; place++) {
+                    if (!accept(static_cast<uint8_t>(
+                                    slotsStart(canonStack) + place),
+                                place < count ? 0 : branch.nextLabel++)) {
+                        return;
+                    }
+                }
+            }
+        }
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            if (values[col] != 0) {
+                branch.labelCol[values[col]] = col;
+            }
+        }
+        for (uint8_t start = 0; start < NUM_STACKS;
+             start = branch.stackCellEnd[start]) {
+            const uint8_t stacks = branch.stackCellStacks[start];
+            if (isSingle(stacks)) {
+                placeStack(branch, firstColumn(stacks));
+            }
+        }
+        searchLine(branch, 1);
+    }
+
+    // Chooses the line that goes to line canonRow of the canonical form.
+    // The candidate lines are all evaluated before going down, so only the
+    // branches with the smallest line are searched further.
+    void searchLine(const Branch &branch, uint8_t canonRow) noexcept {
+        if (canonRow == Board::NUM_ROWS) {
+            if (_bestVersion != _recordedVersion) {
+                // First complete form that matches the improved best.
+                recordTransform(branch);
+            }
+            return;
+        }
+        if (branch.numCells == Board::NUM_COLS &&
+            branch.nextLabel == _numValues + 1 &&
+            none_of(begin(branch.stackAt), end(branch.stackAt),
+                    [](uint8_t stack) { return stack == NO_STACK; })) {
+            completeLines(branch, canonRow);
+            return;
+        }
+        uint8_t first = 0;
+        uint8_t last = Board::NUM_ROWS;
+        if (canonRow % BAND_SIZE != 0) {
+            // Must stay in the band of the previous line.
+            first = branch.rowMap[canonRow - 1] / BAND_SIZE * BAND_SIZE;
+            last = static_cast<uint8_t>(first + BAND_SIZE);
+        }
+        LineBranches found;
+        found.bestVersion = _bestVersion;
+        for (uint8_t row = first; row < last; row++) {
+            if ((branch.usedRows & (1U << row)) != 0) {
+                continue;
+            }
+            if (canonRow % BAND_SIZE == 0 &&
+                (branch.usedRows & (0x7U << (row / BAND_SIZE * BAND_SIZE))) !=
+                    0) {
+                // Band already used.
+                continue;
+            }
+            Branch next = branch;
+            next.rowMap[canonRow] = row;
+            next.usedRows = static_cast<uint16_t>(next.usedRows | (1U << row));
+            scanLine(next, canonRow, 0, found);
+        }
+        searchBelow(found, canonRow);
+    }
+
+    // Adds a branch whose line canonRow matched the best form to the ones
+    // to be searched further - dropping the ones that came before if the
+    // line improved the best form.
+    void addBranch(LineBranches &found, const Branch &branch,
+                   uint8_t canonRow) noexcept {
+        if (found.bestVersion != _bestVersion) {
+            found.numBranches = 0;
+            found.bestVersion = _bestVersion;
+        }
+        if (found.numBranches == MAX_LINE_BRANCHES) {
+            searchBelow(found, canonRow);
+        }
+        found.branches[found.numBranches++] = branch;
+    }
+
+    void searchBelow(LineBranches &found, uint8_t canonRow) noexcept {
+        for (uint8_t i = 0; i < found.numBranches; i++) {
+            searchLine(found.branches[i], static_cast<uint8_t>(canonRow + 1));
+        }
+        // Improvements below don't change line canonRow of the best form.
+        found.numBranches = 0;
+        found.bestVersion = _bestVersion;
+    }
+
+    // Evaluates line canonRow of the canonical form from canonical column pos
+    // on, splitting the cells by the values of the line.
+    void scanLine(Branch &branch, uint8_t canonRow, uint8_t pos,
+                  LineBranches &found) noexcept {
+        const uint8_t *values =
+            _grid + branch.rowMap[canonRow] * Board::NUM_COLS;
+        const auto lineStart =
+            static_cast<uint8_t>(canonRow * Board::NUM_COLS);
+        while (pos < Board::NUM_COLS) {
+            const uint8_t canonStack = pos / BAND_SIZE;
+            if (pos % BAND_SIZE == 0 &&
+                branch.stackAt[canonStack] == NO_STACK) {
+                if (!scanStackCell(branch, canonRow, pos, found)) {
+                    return;
+                }
+                continue;
+            }
+            const auto slot = static_cast<uint8_t>(
+                slotsStart(branch.stackAt[canonStack]) + pos % BAND_SIZE);
+            // The columns of the cell that put the smallest value at pos.
+            uint8_t minKey = 0xFF;
+            uint16_t tied = 0;
+            for (uint16_t left = branch.cellCols[slot]; left != 0;
+                 left &= left - 1) {
+                const uint8_t col = firstColumn(left);
+                const uint8_t key = keyOf(branch, values[col], col, slot);
+                if (key < minKey) {
+                    minKey = key;
+                    tied = columnBit(col);
+                } else if (key == minKey) {
+                    tied |= columnBit(col);
+                }
+            }
+            if (minKey == 0 || minKey == FRESH_KEY) {
+                // Blanks, or values seen for the first time that take the
+                // next labels in whatever order their columns end up, go
+                // first as a cell of their own.
+                splitCell(branch, slot, tied);
+                const auto end =
+                    static_cast<uint8_t>(pos + branch.cellEnd[slot] - slot);
+                if (minKey == FRESH_KEY) {
+                    for (uint16_t left = tied; left != 0; left &= left - 1) {
+                        const uint8_t col = firstColumn(left);
+                        branch.labelCol[values[col]] = col;
+                        branch.labelBase[values[col]] =
+                            static_cast<int8_t>(branch.nextLabel - pos);
+                    }
+                }
+                for (; pos < end; pos++) {
+                    if (!accept(static_cast<uint8_t>(lineStart + pos),
+                                minKey == 0 ? 0 : branch.nextLabel++)) {
+                        return;
+                    }
+                }
+                continue;
+            }
+            if (!accept(static_cast<uint8_t>(lineStart + pos), minKey)) {
+                return;
+            }
+            if (numColumns(tied) == 1) {
+                const uint8_t col = firstColumn(tied);
+                place(branch, values[col], col, slot);
+                pos++;
+                continue;
+            }
+            // Columns that tie on a label are told apart by the lines below.
+            for (uint16_t left = tied; left != 0; left &= left - 1) {
+                const uint8_t col = firstColumn(left);
+                Branch next = branch;
+                place(next, values[col], col, slot);
+                scanLine(next, canonRow, static_cast<uint8_t>(pos + 1), found);
+            }
+            return;
+        }
+        addBranch(found, branch, canonRow);
+    }
+
+    // Evaluates line canonRow at the canonical stacks of a cell of stacks
+    // starting at canonical column pos. Stacks with blanks only in the line
+    // go first and keep their order open; the others are each tried first.
+    // Returns whether the scan of the line goes on from pos.
+    bool scanStackCell(Branch &branch, uint8_t canonRow, uint8_t &pos,
+                       LineBranches &found) noexcept {
+        const uint8_t *values =
+            _grid + branch.rowMap[canonRow] * Board::NUM_COLS;
+        const uint8_t canonStack = pos / BAND_SIZE;
+        const uint8_t stacks = branch.stackCellStacks[canonStack];
+        uint8_t blankStacks = 0;
+        for (uint8_t stack = 0; stack < NUM_STACKS; stack++) {
+            const uint8_t start = slotsStart(stack);
+            if ((stacks & (1U << stack)) != 0 && values[start] == 0 &&
+                values[start + 1] == 0 && values[start + 2] == 0) {
+                blankStacks = static_cast<uint8_t>(blankStacks | (1U << stack));
+            }
+        }
+        if (blankStacks == 0) {
+            for (uint8_t stack = 0; stack < NUM_STACKS; stack++) {
+                if ((stacks & (1U << stack)) != 0) {
+                    Branch next = branch;
+                    placeStack(next, stack);
+                    scanLine(next, canonRow, pos, found);
+                }
+            }
+            return false;
+        }
+        const uint8_t numBlankStacks = CandidateSet(blankStacks).size();
+        const auto end = static_cast<uint8_t>(
+            pos + numBlankStacks * BAND_SIZE);
+        for (; pos < end; pos++) {
+            if (!accept(static_cast<uint8_t>(canonRow * Board::NUM_COLS + pos),
+                        0)) {
+                return false;
+            }
+        }
+        if (blankStacks != stacks) {
+            splitStackCell(branch, canonStack, blankStacks);
+            const auto rest = static_cast<uint8_t>(stacks & ~blankStacks);
+            for (const uint8_t cellStacks : {blankStacks, rest}) {
+                if (isSingle(cellStacks)) {
+                    placeStack(branch, firstColumn(cellStacks));
+                }
+            }
+        }
+        return true;
+    }
+
+    // Places the lines from canonRow on once the columns and the labels are
+    // all fixed: each line then has a form of its own, and the smallest
+    // board has the lines of each band in order and the bands in order of
+    // their lines.
+    void completeLines(const Branch &branch, uint8_t canonRow) noexcept {
+        uint8_t colAt[Board::NUM_COLS];
+        uint8_t colPos[Board::NUM_COLS];
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            const uint8_t stack = col / BAND_SIZE;
+            colPos[col] = static_cast<uint8_t>(
+                slotsStart(branch.stackCellOf[stack]) + branch.cellOf[col] -
+                slotsStart(stack));
+            colAt[colPos[col]] = col;
+        }
+        uint8_t labels[Board::MAX_VAL + 1]{};
+        for (uint8_t val = Board::MIN_VAL; val <= Board::MAX_VAL; val++) {
+            if (branch.labelCol[val] != NO_COLUMN) {
+                labels[val] = static_cast<uint8_t>(
+                    branch.labelBase[val] + colPos[branch.labelCol[val]]);
+            }
+        }
+        // Forms of the lines, a label per 4 bits with the first column in
+        // the highest bits, so they compare as numbers.
+        uint64_t forms[Board::NUM_ROWS]{};
+        for (uint8_t row = 0; row < Board::NUM_ROWS; row++) {
+            if ((branch.usedRows & (1U << row)) != 0) {
+                continue;
+            }
+            const uint8_t *values = _grid + row * Board::NUM_COLS;
+            for (const uint8_t col : colAt) {
+                forms[row] = forms[row] << 4 | labels[values[col]];
+            }
+        }
+        const auto byForm = [&forms](uint8_t row, uint8_t other) {
+            return forms[row] < forms[other];
+        };
+
+        Branch done = branch;
+        uint8_t line = canonRow;
+        if (canonRow % BAND_SIZE != 0) {
+            // The rest of the band of the previous line.
+            const uint8_t first =
+                branch.rowMap[canonRow - 1] / BAND_SIZE * BAND_SIZE;
+            for (uint8_t row = first; row < first + BAND_SIZE; row++) {
+                if ((branch.usedRows & (1U << row)) == 0) {
+                    done.rowMap[line++] = row;
+                }
+            }
+            sort(done.rowMap + canonRow, done.rowMap + line, byForm);
+        }
+        const uint8_t bandsStart = line;
+        for (uint8_t first = 0; first < Board::NUM_ROWS; first += BAND_SIZE) {
+            if ((branch.usedRows & (0x7U << first)) == 0) {
+                uint8_t *band = done.rowMap + line;
+                for (uint8_t row = first; row < first + BAND_SIZE; row++) {
+                    done.rowMap[line++] = row;
+                }
+                sort(band, band + BAND_SIZE, byForm);
+            }
+        }
+        // Bands are ordered by their lines, the first one deciding.
+        for (uint8_t band = bandsStart; band < line; band += BAND_SIZE) {
+            for (uint8_t other = band + BAND_SIZE; other < line;
+                 other += BAND_SIZE) {
+                if (lexicographical_compare(
+                        done.rowMap + other, done.rowMap + other + BAND_SIZE,
+                        done.rowMap + band, done.rowMap + band + BAND_SIZE,
+                        byForm)) {
+                    swap_ranges(done.rowMap + band,
+                                done.rowMap + band + BAND_SIZE,
+                                done.rowMap + other);
+                }
+            }
+        }
+
+        for (line = canonRow; line < Board::NUM_ROWS; line++) {
+            const uint8_t *values = _grid + done.rowMap[line] * Board::NUM_COLS;
+            for (uint8_t pos = 0; pos < Board::NUM_COLS; pos++) {
+                if (!accept(static_cast<uint8_t>(line * Board::NUM_COLS + pos),
+                            labels[values[colAt[pos]]])) {
+                    return;
+                }
+            }
+        }
+        if (_bestVersion != _recordedVersion) {
+            recordTransform(done);
+        }
+    }
+
+    void recordTransform(const Branch &branch) noexcept {
+        _recordedVersion = _bestVersion;
+        _bestTransform.transposed = _transposed;
+        copy(begin(branch.rowMap), end(branch.rowMap),
+             begin(_bestTransform.rowMap));
+        // Any order inside the cells left gives the best form.
+        uint8_t colPos[Board::NUM_COLS]{};
+        for (uint8_t canonStart = 0; canonStart < NUM_STACKS;
+             canonStart = branch.stackCellEnd[canonStart]) {
+            auto pos = static_cast<uint8_t>(slotsStart(canonStart));
+            for (uint8_t stack = 0; stack < NUM_STACKS; stack++) {
+                if ((branch.stackCellStacks[canonStart] & (1U << stack)) ==
+                    0) {
+                    continue;
+                }
+                const uint8_t start = slotsStart(stack);
+                for (uint8_t slot = start; slot < start + BAND_SIZE;
+                     slot = branch.cellEnd[slot]) {
+                    for (uint8_t col = start; col < start + BAND_SIZE;
+                         col++) {
+                        if ((branch.cellCols[slot] & columnBit(col)) != 0) {
+                            _bestTransform.colMap[pos] = col;
+                            colPos[col] = pos++;
+                        }
+                    }
+                }
+            }
+        }
+        // Values absent from the board get the remaining labels, in order, so
+        // the value map is always a bijection.
+        uint8_t nextLabel = branch.nextLabel;
+        _bestTransform.valueMap[0] = 0;
+        for (uint8_t val = Board::MIN_VAL; val <= Board::MAX_VAL; val++) {
+            const uint8_t labelCol = branch.labelCol[val];
+            _bestTransform.valueMap[val] =
+                labelCol != NO_COLUMN
+                    ? static_cast<uint8_t>(branch.labelBase[val] +
+                                           colPos[labelCol])
+                    : nextLabel++;
+        }
+    }
+
+    uint8_t _grids[2][Board::NUM_POS]{};
+    const uint8_t *_grid{nullptr};
+    bool _transposed{false};
+    // Number of distinct values of the board.
+    uint8_t _numValues{0};
+
+    // Best form found so far; only its first _bestLen positions are known.
+    uint8_t _best[Board::NUM_POS]{};
+    uint8_t _bestLen{0};
+    unsigned _bestVersion{0};
+    unsigned _recordedVersion{0};
+    Transform _bestTransform;
+};
+
+uint8_t sourceValue(const Board &board, bool transposed, uint8_t row,
+                    uint8_t col) {
+    return transposed ? board.valueAt(col, row) : board.valueAt(row, col);
+}
+
+}  // namespace
+
+Board sudoku::canonicalize(const Board &board, Transform *transform) {
+    if (!board.isValid()) {
+        // The labels of the search assume a value is seen at most once per
+        // line.
+        if (transform != nullptr) {
+            *transform = Transform();
+        }
+        return board;
+    }
+
+    Canonicalizer canonicalizer(board);
+    canonicalizer.run();
+
+    if (transform != nullptr) {
+        *transform = canonicalizer.bestTransform();
+    }
+    array<uint8_t, Board::NUM_POS> values{};
+    copy(canonicalizer.best(), canonicalizer.best() + Board::NUM_POS,
+         values.begin());
+    return Board(values);
+}
+
+Board sudoku::applyTransform(const Board &board, const Transform &transform) {
+    array<uint8_t, Board::NUM_POS> values{};
+    for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            const uint8_t val =
+                sourceValue(board, transform.transposed, transform.rowMap[lin],
+                            transform.colMap[col]);
+            values[lin * Board::NUM_COLS + col] =
+                val <= Board::MAX_VAL ? transform.valueMap[val] : val;
+        }
+    }
+    return Board(values);
+}
+
+Board sudoku::revertTransform(const Board &board, const Transform &transform) {
+    uint8_t inverseValueMap[Board::MAX_VAL + 1]{};
+    for (uint8_t val = 0; val <= Board::MAX_VAL; val++) {
+        inverseValueMap[transform.valueMap[val]] = val;
+    }
+    array<uint8_t, Board::NUM_POS> values{};
+    for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            uint8_t origLin = transform.rowMap[lin];
+            uint8_t origCol = transform.colMap[col];
+            if (transform.transposed) {
+                std::swap(origLin, origCol);
+            }
+            const uint8_t val = board.valueAt(lin, col);
+            values[origLin * Board::NUM_COLS + origCol] =
+                val <= Board::MAX_VAL ? inverseValueMap[val] : val;
+        }
+    }
+    return Board(values);
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,60 @@
+#ifndef CANONICAL_FORM_H
+#define CANONICAL_FORM_H
+
+#include <cstdint>
+
+#include "board.h"
+
+namespace sudoku {
+
+/**
+ * @brief A Sudoku symmetry: an optional transposition followed by a row
+ * permutation, a column permutation and a relabeling of the values.
+ *
+ * The transformed board has, at position (line, column), the relabeled value
+ * of position (rowMap[line], colMap[column]) of the (possibly transposed)
+ * original board. Row and column permutations only ever swap bands and stacks
+ * and lines or columns inside a band or stack.
+ */
+struct Transform {
+    bool transposed{false};
+    std::uint8_t rowMap[Board::NUM_ROWS]{0, 1, 2, 3, 4, 5, 6, 7, 8};
+    std::uint8_t colMap[Board::NUM_COLS]{0, 1, 2, 3, 4, 5, 6, 7, 8};
+    // Value in the original board -> value in the transformed board. Blanks
+    // are always mapped to blanks.
+    std::uint8_t valueMap[Board::MAX_VAL + 1]{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+};
+
+/**
+ * @brief Computes the minimum lexicographic representative (minlex) of the
+ * class of boards that are equivalent to a given board under the Sudoku
+ * symmetries.
+ *
+ * The board is read in line-major order, blanks being smaller than any value.
+ * Isomorphic boards - boards that differ only by value relabeling, line and
+ * column permutations within bands and stacks, band and stack permutations
+ * and transposition - have the same canonical form.
+ *
+ * @param board the board to be canonicalized. An invalid board - with values
+ * out of the 0 to 9 range or repeated in a line, column or section - is
+ * returned unchanged with the identity transform.
+ * @param transform if not null, receives the transform that maps board into
+ * its canonical form.
+ * @return the canonical form of the board.
+ */
+Board canonicalize(const Board &board, Transform *transform = nullptr);
+
+/**
+ * @brief Applies a transform to a board.
+ */
+Board applyTransform(const Board &board, const Transform &transform);
+
+/**
+ * @brief Applies the inverse of a transform to a board - maps, for instance,
+ * the solution of a canonical puzzle back to a solution of the original one.
+ */
+Board revertTransform(const Board &board, const Transform &transform);
+
+}  // namespace sudoku
+
+#endif
@@ -0,0 +1,210 @@
+#include "difficulty_rating.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "board.h"
+#include "candidate_set.h"
+#include "generator.h"
+#include "logical_solver.h"
+#include "unit_tables.h"
+
+using namespace std;
+using namespace sudoku;
+
+namespace {
+
+const uint16_t ALL_VALUES = CandidateSet::ALL_MASK;
+
+// Score of each technique, in the order they are tried by the logical
+// solver. Consecutive scores are at least 0.3 apart, so the bonus for
+// repeated applications never reaches the next technique.
+const double TECHNIQUE_SCORES[NUM_TECHNIQUES]{
+    1.0, 1.5, 2.0, 2.5, 3.0, 3.3, 3.6, 4.0, 4.3, 4.6, 5.0, 5.5, 6.0};
+// Bonus for each application of the hardest technique after the first.
+const double REPEAT_BONUS = 0.05;
+const unsigned MAX_REPEATS = 4;
+
+// Score of a puzzle that needs a single pair of guesses; each doubling of
+// the number of guesses adds 1.0.
+const double SEARCH_SCORE = 7.0;
+
+// Stops the search of puzzles with several solutions.
+const unsigned MAX_SOLUTIONS = 2;
+
+/**
+ * @brief The candidates of every position during the search - a single
+ * candidate for the filled ones.
+ */
+struct SearchState {
+    uint16_t candidates[Board::NUM_POS];
+    // Whether the single candidate of a position has been taken off its
+    // peers.
+    bool fixed[Board::NUM_POS];
+};
+
+inline bool isSingle(uint16_t mask) noexcept {
+    return (mask & (mask - 1)) == 0;
+}
+
+/**
+ * @brief Propagates naked and hidden singles until nothing changes.
+ *
+ * @return false if a position or a value of a unit ran out of candidates.
+ */
+bool propagate(SearchState &state) noexcept {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+            const uint16_t mask = state.candidates[pos];
+            if (state.fixed[pos] || !isSingle(mask)) {
+                continue;
+            }
+            state.fixed[pos] = true;
+            for (const uint8_t peer : UNIT_TABLES.peers[pos]) {
+                uint16_t &peerMask = state.candidates[peer];
+                if ((peerMask & mask) == 0) {
+                    continue;
+                }
+                peerMask &= static_cast<uint16_t>(~mask);
+                if (peerMask == 0) {
+                    return false;
+                }
+                changed = true;
+            }
+        }
+        for (const auto &unit : UNIT_TABLES.units) {
+            uint16_t once = 0;
+            uint16_t twice = 0;
+            for (const uint8_t pos : unit) {
+                twice |= once & state.candidates[pos];
+                once |= state.candidates[pos];
+            }
+            if (once != ALL_VALUES) {
+                return false;
+            }
+            const uint16_t hidden = once & static_cast<uint16_t>(~twice);
+            if (hidden == 0) {
+                continue;
+            }
+            for (const uint8_t pos : unit) {
+                const uint16_t mask = state.candidates[pos];
+                if ((mask & hidden) == 0 || isSingle(mask)) {
+                    continue;
+                }
+                state.candidates[pos] = mask & hidden;
+                if (!isSingle(state.candidates[pos])) {
+                    // Two values that only fit the same position.
+                    return false;
+                }
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Searches the solutions of a state, guessing at the position with
+ * fewest candidates.
+ *
+ * @param state the state to be searched - already propagated.
+ * @param numSolutions the number of solutions found so far.
+ * @param numGuesses the number of guesses made so far.
+ */
+void search(const SearchState &state, unsigned &numSolutions,
+            uint32_t &numGuesses) noexcept {
+    uint8_t guessPos = Board::NUM_POS;
+    uint8_t fewest = Board::MAX_VAL + 1;
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        const uint8_t numCandidates =
+            CandidateSet(state.candidates[pos]).size();
+        if (numCandidates > 1 && numCandidates < fewest) {
+            fewest = numCandidates;
+            guessPos = pos;
+        }
+    }
+    if (guessPos == Board::NUM_POS) {
+        numSolutions++;
+        return;
+    }
+    for (const uint8_t value : CandidateSet(state.candidates[guessPos])) {
+        if (numSolutions >= MAX_SOLUTIONS) {
+            return;
+        }
+        numGuesses++;
+        SearchState guessed = state;
+        guessed.candidates[guessPos] =
+            static_cast<uint16_t>(1U << (value - 1U));
+        if (propagate(guessed)) {
+            search(guessed, numSolutions, numGuesses);
+        }
+    }
+}
+
+PuzzleDifficulty levelOf(const DifficultyRating &rating) noexcept {
+    if (!rating.solvedLogically ||
+        rating.hardestTechnique >= Technique::XWing) {
+        return PuzzleDifficulty::Hard;
+    }
+    return rating.hardestTechnique > Technique::HiddenSingle
+               ? PuzzleDifficulty::Medium
+               : PuzzleDifficulty::Easy;
+}
+
+}  // namespace
+
+DifficultyRating sudoku::rateDifficulty(const Board &board) {
+    // Reused across calls, so the trace of the solver is allocated once per
+    // thread.
+    thread_local LogicalSolver logicalSolver;
+
+    DifficultyRating rating;
+    const LogicalResult result = logicalSolver.solve(board);
+    if (result == LogicalResult::InvalidBoard ||
+        result == LogicalResult::HasNoSolution) {
+        return rating;
+    }
+    rating.hardestTechnique = logicalSolver.hardestTechnique();
+    rating.solvedLogically = result == LogicalResult::Solved;
+
+    if (rating.solvedLogically) {
+        // A board without blanks has no application at all.
+        const unsigned timesUsed =
+            logicalSolver.timesUsed(rating.hardestTechnique);
+        const unsigned repeats =
+            timesUsed > 0 ? min(timesUsed - 1, MAX_REPEATS) : 0;
+        rating.score =
+            TECHNIQUE_SCORES[static_cast<size_t>(rating.hardestTechnique)] +
+            REPEAT_BONUS * repeats;
+    } else {
+        // The search starts from the candidates the deductions left.
+        const Board reached = logicalSolver.board();
+        SearchState state{};
+        for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+            for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+                const uint8_t pos = lin * Board::NUM_COLS + col;
+                const uint8_t value = reached.valueAt(lin, col);
+                state.candidates[pos] =
+                    value != 0 ? static_cast<uint16_t>(1U << (value - 1U))
+                               : logicalSolver.candidates(lin, col).mask();
+            }
+        }
+        unsigned numSolutions = 0;
+        if (propagate(state)) {
+            search(state, numSolutions, rating.numGuesses);
+        }
+        if (numSolutions == 0) {
+            return rating;
+        }
+        rating.score =
+            SEARCH_SCORE +
+            log2(max(static_cast<double>(rating.numGuesses) / 2.0, 1.0));
+    }
+    rating.solvable = true;
+    rating.level = levelOf(rating);
+    return rating;
+}
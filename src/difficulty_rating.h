@@ -0,0 +1,52 @@
+#ifndef DIFFICULTY_RATING_H
+#define DIFFICULTY_RATING_H
+
+#include <cstdint>
+
+#include "board.h"
+#include "generator.h"
+#include "logical_solver.h"
+
+namespace sudoku {
+
+/**
+ * @brief The difficulty of a puzzle, as rated by rateDifficulty.
+ */
+struct DifficultyRating {
+    // The numeric score - higher is harder. Puzzles solved by deductions
+    // score from 1.0 (naked singles only) to 6.0 (simple coloring); puzzles
+    // that also need guessing score from 7.0 up, growing with the log of the
+    // number of guesses. Invalid or unsolvable boards score 0.0.
+    double score{0.0};
+    // The difficulty level the score falls in.
+    PuzzleDifficulty level{PuzzleDifficulty::Easy};
+    // The hardest technique applied by the logical solver.
+    Technique hardestTechnique{Technique::NakedSingle};
+    // Whether the deductions alone solved the puzzle.
+    bool solvedLogically{false};
+    // The guesses made by the search that took over from the deductions.
+    std::uint32_t numGuesses{0};
+    // Whether the board is valid and has at least one solution.
+    bool solvable{false};
+};
+
+/**
+ * @brief Rates how hard a puzzle is for a person to solve.
+ *
+ * The puzzle is first solved with the deductions of LogicalSolver; the
+ * hardest technique it needs sets the score. When the deductions get stuck,
+ * the candidates left are searched with singles propagation until a second
+ * solution is found or the search space is exhausted, and the number of
+ * guesses made sets the score instead.
+ *
+ * Allocation free after the first call on a thread, so it is meant to be
+ * used to rate large collections of puzzles.
+ *
+ * @param board the puzzle to be rated.
+ * @return the rating of the puzzle.
+ */
+DifficultyRating rateDifficulty(const Board &board);
+
+}  // namespace sudoku
+
+#endif
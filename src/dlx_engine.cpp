@@ -0,0 +1,248 @@
+#include "dlx_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include "board.h"
+#include "candidate_set.h"
+
+using namespace std;
+using namespace sudoku;
+
+template <typename SolutionVisitor, typename ProgressVisitor>
+uint64_t DlxEngine::explore(const Board &board, SolutionVisitor &&onSolution,
+                            ProgressVisitor &&onProgress) {
+    if (!build(board)) {
+        return 0;
+    }
+
+    uint64_t numSolutions = 0;
+    double progressPercent = 0.0;
+    double numRootBranches = 1.0;
+    double rootBranchesTaken = 0.0;
+    uint8_t level = 0;
+    // Whether the search goes down one level - otherwise it backtracks.
+    bool descend = true;
+    while (true) {
+        if (descend) {
+            if (_right[ROOT] == ROOT) {
+                // All the constraints are satisfied.
+                numSolutions++;
+                if (!onSolution(level)) {
+                    break;
+                }
+                descend = false;
+                continue;
+            }
+            const uint16_t column = selectColumn();
+            if (level == 0) {
+                numRootBranches = _size[column];
+            }
+            if (counting() && _size[column] == 0) {
+                // A constraint no row satisfies anymore.
+                _stats->backtracks++;
+            }
+            cover(column);
+            _chosen[level] = _down[column];
+        } else {
+            // Removes the row chosen at the previous level and moves on to
+            // the next row of its column.
+            if (level == 0) {
+                break;
+            }
+            level--;
+            const uint16_t node = _chosen[level];
+            for (uint16_t j = _left[node]; j != node; j = _left[j]) {
+                uncover(_column[j]);
+            }
+            _chosen[level] = _down[node];
+        }
+
+        const uint16_t node = _chosen[level];
+        if (node == _column[node]) {
+            // Back at the column header - all the rows have been tried.
+            uncover(_column[node]);
+            descend = false;
+            continue;
+        }
+        if (level == 0) {
+            rootBranchesTaken += 1.0;
+            progressPercent = rootBranchesTaken / numRootBranches * 100.0;
+        }
+        if (!onProgress(progressPercent)) {
+            break;
+        }
+        for (uint16_t j = _right[node]; j != node; j = _right[j]) {
+            cover(_column[j]);
+        }
+        level++;
+        if (counting()) {
+            _stats->nodes++;
+            _stats->maxDepth =
+                max(_stats->maxDepth, static_cast<uint32_t>(level));
+        }
+        descend = true;
+    }
+    return numSolutions;
+}
+
+unsigned DlxEngine::search(const Board &board,
+                           const SolutionCallback &onSolution,
+                           const ProgressCallback &onProgress) {
+    return static_cast<unsigned>(explore(
+        board,
+        [this, &onSolution](uint8_t level) {
+            uint8_t values[Board::NUM_POS];
+            toValues(level, values);
+            return onSolution(Board::fromValues(values));
+        },
+        [&onProgress](double progressPercent) {
+            return onProgress == nullptr || onProgress(progressPercent);
+        }));
+}
+
+uint64_t DlxEngine::count(const Board &board, uint64_t limit,
+                          uint8_t *solution, const atomic<bool> *cancelled) {
+    if (limit == 0) {
+        return 0;
+    }
+    uint64_t numSolutions = 0;
+    explore(
+        board,
+        [this, &numSolutions, limit, solution](uint8_t level) {
+            if (numSolutions == 0 && solution != nullptr) {
+                toValues(level, solution);
+            }
+            return ++numSolutions < limit;
+        },
+        [cancelled](double) {
+            return cancelled == nullptr || !cancelled->load();
+        });
+    return numSolutions;
+}
+
+bool DlxEngine::build(const Board &board) noexcept {
+    if (!board.isValid()) {
+        // The values of the board index the columns - an out of range one
+        // would fall outside of them.
+        return false;
+    }
+    // Columns satisfied by the values in the board are left out of the
+    // header list; the rows of the blank positions are only created for
+    // their candidates, so no row touches a satisfied column.
+    bool satisfied[1 + NUM_COLUMNS]{};
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        const uint8_t lin = pos / Board::NUM_COLS;
+        const uint8_t col = pos % Board::NUM_COLS;
+        const uint8_t value = board.valueAt(lin, col);
+        _values[pos] = value;
+        if (value != 0) {
+            const uint8_t sec = lin / 3 * 3 + col / 3;
+            satisfied[1 + pos] = true;
+            satisfied[1 + Board::NUM_POS + lin * 9 + value - 1] = true;
+            satisfied[1 + 2 * Board::NUM_POS + col * 9 + value - 1] = true;
+            satisfied[1 + 3 * Board::NUM_POS + sec * 9 + value - 1] = true;
+        }
+    }
+
+    _left[ROOT] = ROOT;
+    _right[ROOT] = ROOT;
+    for (uint16_t column = 1; column <= NUM_COLUMNS; column++) {
+        _up[column] = column;
+        _down[column] = column;
+        _column[column] = column;
+        _size[column] = 0;
+        if (!satisfied[column]) {
+            _left[column] = _left[ROOT];
+            _right[column] = ROOT;
+            _right[_left[ROOT]] = column;
+            _left[ROOT] = column;
+        }
+    }
+
+    uint16_t nextNode = 1 + NUM_COLUMNS;
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        const uint8_t lin = pos / Board::NUM_COLS;
+        const uint8_t col = pos % Board::NUM_COLS;
+        const uint8_t sec = lin / 3 * 3 + col / 3;
+        for (const uint8_t value : board.getCandidates(lin, col)) {
+            const uint16_t columns[4]{
+                static_cast<uint16_t>(1 + pos),
+                static_cast<uint16_t>(1 + Board::NUM_POS + lin * 9 + value - 1),
+                static_cast<uint16_t>(1 + 2 * Board::NUM_POS + col * 9 + value -
+                                      1),
+                static_cast<uint16_t>(1 + 3 * Board::NUM_POS + sec * 9 + value -
+                                      1)};
+            const uint16_t first = nextNode;
+            for (uint8_t k = 0; k < 4; k++) {
+                const uint16_t node = nextNode++;
+                const uint16_t column = columns[k];
+                _column[node] = column;
+                _row[node] = static_cast<uint16_t>(pos * 9 + value - 1);
+                _up[node] = _up[column];
+                _down[node] = column;
+                _down[_up[column]] = node;
+                _up[column] = node;
+                _size[column]++;
+                _left[node] = k == 0 ? static_cast<uint16_t>(first + 3)
+                                     : static_cast<uint16_t>(node - 1);
+                _right[node] = k == 3 ? first : static_cast<uint16_t>(node + 1);
+            }
+        }
+    }
+    return true;
+}
+
+void DlxEngine::cover(uint16_t column) noexcept {
+    if (counting()) {
+        // The rows of the column are the candidates taken off.
+        _stats->eliminations += _size[column];
+    }
+    _right[_left[column]] = _right[column];
+    _left[_right[column]] = _left[column];
+    for (uint16_t i = _down[column]; i != column; i = _down[i]) {
+        for (uint16_t j = _right[i]; j != i; j = _right[j]) {
+            _down[_up[j]] = _down[j];
+            _up[_down[j]] = _up[j];
+            _size[_column[j]]--;
+        }
+    }
+}
+
+void DlxEngine::uncover(uint16_t column) noexcept {
+    for (uint16_t i = _up[column]; i != column; i = _up[i]) {
+        for (uint16_t j = _left[i]; j != i; j = _left[j]) {
+            _size[_column[j]]++;
+            _down[_up[j]] = j;
+            _up[_down[j]] = j;
+        }
+    }
+    _right[_left[column]] = column;
+    _left[_right[column]] = column;
+}
+
+uint16_t DlxEngine::selectColumn() const noexcept {
+    // Knuth's S heuristic - the column with the fewest rows.
+    uint16_t selected = _right[ROOT];
+    for (uint16_t column = _right[ROOT]; column != ROOT;
+         column = _right[column]) {
+        if (_size[column] < _size[selected]) {
+            selected = column;
+            if (_size[column] <= 1) {
+                break;
+            }
+        }
+    }
+    return selected;
+}
+
+void DlxEngine::toValues(uint8_t level, uint8_t *values) const noexcept {
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        values[pos] = _values[pos];
+    }
+    for (uint8_t i = 0; i < level; i++) {
+        const uint16_t row = _row[_chosen[i]];
+        values[row / 9] = static_cast<uint8_t>(row % 9 + 1);
+    }
+}
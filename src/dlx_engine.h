@@ -0,0 +1,99 @@
+#ifndef DLX_ENGINE_H
+#define DLX_ENGINE_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "board.h"
+#include "search_engine.h"
+
+namespace sudoku {
+
+/**
+ * @brief Solving engine that runs Knuth's Algorithm X with Dancing Links over
+ * the exact cover matrix of a 9x9 board.
+ *
+ * The matrix has one column per constraint - each position filled once and
+ * each value placed once in each line, column and section - and one row per
+ * (position, value) pair. All the nodes live in a pool preallocated with the
+ * engine and the search is iterative, so solving makes no allocations. The
+ * engine pays off when enumerating the many solutions of boards with few
+ * values.
+ */
+class DlxEngine : public SearchEngine {
+   public:
+    static const std::uint8_t CAPABILITIES =
+        FirstSolution | Counting | Enumeration;
+
+    std::uint8_t capabilities() const noexcept override {
+        return CAPABILITIES;
+    }
+
+    unsigned search(const Board &board, const SolutionCallback &onSolution,
+                    const ProgressCallback &onProgress) override;
+
+    std::uint64_t count(const Board &board, std::uint64_t limit,
+                        std::uint8_t *solution,
+                        const std::atomic<bool> *cancelled) override;
+
+   private:
+    static const std::uint16_t NUM_COLUMNS = 4 * Board::NUM_POS;
+    static const std::uint16_t NUM_ROWS = Board::NUM_POS * Board::MAX_VAL;
+    // The root, the column headers and four nodes per row.
+    static const std::uint16_t NUM_NODES = 1 + NUM_COLUMNS + 4 * NUM_ROWS;
+    static const std::uint16_t ROOT = 0;
+
+    /**
+     * @brief The search loop shared by search and count.
+     *
+     * @param onSolution called, with the depth of the solution found, for
+     * each solution found; returning false stops the search.
+     * @param onProgress called with the progress of the search whenever the
+     * search branches; returning false stops the search.
+     * @return the number of solutions found.
+     */
+    template <typename SolutionVisitor, typename ProgressVisitor>
+    std::uint64_t explore(const Board &board, SolutionVisitor &&onSolution,
+                          ProgressVisitor &&onProgress);
+
+    /**
+     * @brief Builds the exact cover matrix of a board.
+     *
+     * @return false, with nothing built, for an invalid board.
+     */
+    bool build(const Board &board) noexcept;
+
+    void cover(std::uint16_t column) noexcept;
+
+    void uncover(std::uint16_t column) noexcept;
+
+    std::uint16_t selectColumn() const noexcept;
+
+    /**
+     * @brief Writes the values of the solution found at a given level, in
+     * line-major order.
+     */
+    void toValues(std::uint8_t level, std::uint8_t *values) const noexcept;
+
+    // Links of the nodes - the first 1 + NUM_COLUMNS nodes are the root and
+    // the column headers.
+    std::uint16_t _left[NUM_NODES]{};
+    std::uint16_t _right[NUM_NODES]{};
+    std::uint16_t _up[NUM_NODES]{};
+    std::uint16_t _down[NUM_NODES]{};
+    std::uint16_t _column[NUM_NODES]{};
+    // Matrix row of each node - a row is a (position, value) pair.
+    std::uint16_t _row[NUM_NODES]{};
+    // Number of nodes of each column.
+    std::uint16_t _size[1 + NUM_COLUMNS]{};
+
+    // Values of the board being solved, with the given values already set.
+    std::uint8_t _values[Board::NUM_POS]{};
+
+    // Node chosen at each search level.
+    std::uint16_t _chosen[Board::NUM_POS]{};
+};
+
+}  // namespace sudoku
+
+#endif
@@ -240,8 +240,8 @@ void Generator::generate(PuzzleDifficulty difficulty,
                 // Async solving finished - as we departed from a valid and
                 // solvable board there's no need to test for SolverResult
                 // value.
-                solvingFinished = true;
                 boardSolutions = solutions;
+                solvingFinished = true;
             },
             20);
 
@@ -8,7 +8,10 @@
 
 namespace sudoku {
 
-class Board;
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+class BasicBoard;
+
+using Board = BasicBoard<3, 3>;
 
 enum class PuzzleDifficulty : uint8_t { Easy, Medium, Hard };
 
@@ -0,0 +1,233 @@
+#include "lockstep_propagator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "board.h"
+#include "candidate_set.h"
+#include "unit_tables.h"
+
+using namespace std;
+using namespace sudoku;
+
+// The kernel is cloned for AVX2 and for the baseline instruction set; the
+// clone to run is resolved when the library is loaded, from the features of
+// the CPU.
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+#define LOCKSTEP_TARGETS __attribute__((target_clones("avx2", "default")))
+#else
+#define LOCKSTEP_TARGETS
+#endif
+
+namespace {
+
+const size_t NUM_LANES = LockstepPropagator::NUM_LANES;
+const uint16_t ALL_VALUES = CandidateSet::ALL_MASK;
+
+#if defined(__GNUC__)
+
+// The helpers below are always inlined into the kernel - even in unoptimized
+// builds - so vectors are never passed between functions built for different
+// instruction sets.
+#pragma GCC diagnostic ignored "-Wpsabi"
+#define LANES_INLINE inline __attribute__((always_inline))
+
+// One mask per lane, operated on as a whole through the vector extensions of
+// GCC and Clang.
+typedef uint16_t Lanes
+    __attribute__((vector_size(NUM_LANES * sizeof(uint16_t))));
+
+LANES_INLINE Lanes broadcast(uint16_t mask) noexcept {
+    return Lanes{} + mask;
+}
+
+// All bits set in the lanes where the mask is 0.
+LANES_INLINE Lanes zeroLanes(const Lanes &masks) noexcept {
+    return reinterpret_cast<Lanes>(masks == 0);
+}
+
+#else
+
+#define LANES_INLINE inline
+
+// One mask per lane - a plain loop over the lanes for the compilers without
+// vector extensions.
+struct Lanes {
+    uint16_t lanes[NUM_LANES]{};
+
+    uint16_t operator[](size_t lane) const noexcept { return lanes[lane]; }
+
+    template <typename Op>
+    Lanes apply(Op op) const noexcept {
+        Lanes result;
+        for (size_t lane = 0; lane < NUM_LANES; lane++) {
+            result.lanes[lane] = static_cast<uint16_t>(op(lanes[lane]));
+        }
+        return result;
+    }
+
+    template <typename Op>
+    Lanes apply(Lanes other, Op op) const noexcept {
+        Lanes result;
+        for (size_t lane = 0; lane < NUM_LANES; lane++) {
+            result.lanes[lane] =
+                static_cast<uint16_t>(op(lanes[lane], other.lanes[lane]));
+        }
+        return result;
+    }
+
+    Lanes operator&(Lanes other) const noexcept {
+        return apply(other, [](uint16_t a, uint16_t b) { return a & b; });
+    }
+    Lanes operator|(Lanes other) const noexcept {
+        return apply(other, [](uint16_t a, uint16_t b) { return a | b; });
+    }
+    Lanes operator^(Lanes other) const noexcept {
+        return apply(other, [](uint16_t a, uint16_t b) { return a ^ b; });
+    }
+    Lanes operator~() const noexcept {
+        return apply([](uint16_t a) { return ~a; });
+    }
+    Lanes operator-(uint16_t value) const noexcept {
+        return apply([value](uint16_t a) { return a - value; });
+    }
+    Lanes &operator|=(Lanes other) noexcept { return *this = *this | other; }
+};
+
+inline Lanes broadcast(uint16_t mask) noexcept {
+    return Lanes{}.apply([mask](uint16_t) { return mask; });
+}
+
+inline Lanes zeroLanes(const Lanes &masks) noexcept {
+    return masks.apply([](uint16_t a) { return a == 0 ? 0xFFFFU : 0U; });
+}
+
+#endif
+
+// The masks with a single bit set - 0 for the others.
+LANES_INLINE Lanes singles(const Lanes &masks) noexcept {
+    return masks & zeroLanes(masks & (masks - 1));
+}
+
+/**
+ * @brief Propagates singles on all the lanes until no lane that hasn't
+ * failed changes anymore.
+ *
+ * Each round first gathers, for each unit, the values fixed and the hidden
+ * singles from the candidates of its positions, then updates every position
+ * from the units it belongs to. Lanes are never branched on.
+ *
+ * @param masks the candidates of each position in each lane.
+ * @param failedMasks receives a non zero value for the lanes found without
+ * solution.
+ */
+LOCKSTEP_TARGETS
+void propagateLanes(uint16_t (*masks)[NUM_LANES],
+                    uint16_t *failedMasks) noexcept {
+    Lanes candidates[Board::NUM_POS];
+    memcpy(candidates, masks, sizeof(candidates));
+    Lanes unitFixed[Board::NUM_UNITS];
+    Lanes unitHidden[Board::NUM_UNITS];
+    const Lanes allValues = broadcast(ALL_VALUES);
+    Lanes failed{};
+    bool progressing = true;
+    while (progressing) {
+        for (uint8_t unit = 0; unit < Board::NUM_UNITS; unit++) {
+            Lanes fixed{};
+            Lanes repeated{};
+            Lanes once{};
+            Lanes twice{};
+            for (const uint8_t pos : UNIT_TABLES.units[unit]) {
+                const Lanes posCandidates = candidates[pos];
+                const Lanes posSingles = singles(posCandidates);
+                repeated |= fixed & posSingles;
+                fixed |= posSingles;
+                twice |= once & posCandidates;
+                once |= posCandidates;
+            }
+            unitFixed[unit] = fixed;
+            unitHidden[unit] = once & ~twice;
+            // A value fixed twice or missing from the unit.
+            failed |= repeated | (once ^ allValues);
+        }
+
+        Lanes changed{};
+        for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+            const uint8_t *units = UNIT_TABLES.posUnits[pos];
+            const Lanes posCandidates = candidates[pos];
+            // Naked singles of the peers; a fixed position keeps its own
+            // value.
+            const Lanes peersFixed =
+                (unitFixed[units[0]] | unitFixed[units[1]] |
+                 unitFixed[units[2]]) &
+                ~singles(posCandidates);
+            Lanes updated = posCandidates & ~peersFixed;
+            // Hidden singles - two of them at a position leave the board
+            // without solution.
+            const Lanes hidden = (unitHidden[units[0]] | unitHidden[units[1]] |
+                                  unitHidden[units[2]]) &
+                                 updated;
+            updated = hidden | (updated & zeroLanes(hidden));
+            failed |= zeroLanes(updated) | (hidden & (hidden - 1));
+            changed |= posCandidates ^ updated;
+            candidates[pos] = updated;
+        }
+
+        const Lanes active = changed & zeroLanes(failed);
+        uint16_t anyActive = 0;
+        for (size_t lane = 0; lane < NUM_LANES; lane++) {
+            anyActive |= active[lane];
+        }
+        progressing = anyActive != 0;
+    }
+
+    memcpy(masks, candidates, sizeof(candidates));
+    for (size_t lane = 0; lane < NUM_LANES; lane++) {
+        failedMasks[lane] = failed[lane];
+    }
+}
+
+}  // namespace
+
+void LockstepPropagator::propagate(const Board *boards, size_t numBoards,
+                                   Board *propagatedBoards,
+                                   Outcome *outcomes) noexcept {
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        const uint8_t lin = pos / Board::NUM_COLS;
+        const uint8_t col = pos % Board::NUM_COLS;
+        for (size_t lane = 0; lane < NUM_LANES; lane++) {
+            // Unused lanes have the same value at every position, so they
+            // fail in the first round.
+            uint16_t mask = 1;
+            if (lane < numBoards) {
+                const uint8_t value = boards[lane].valueAt(lin, col);
+                mask = value == 0 ? ALL_VALUES
+                                  : static_cast<uint16_t>(1U << (value - 1U));
+            }
+            _candidates[pos][lane] = mask;
+        }
+    }
+
+    propagateLanes(_candidates, _failed);
+
+    for (size_t lane = 0; lane < numBoards; lane++) {
+        if (_failed[lane] != 0) {
+            outcomes[lane] = Outcome::NoSolution;
+            continue;
+        }
+        uint8_t values[Board::NUM_POS];
+        bool solved = true;
+        for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+            const CandidateSet candidates(_candidates[pos][lane]);
+            if (candidates.size() == 1) {
+                values[pos] = candidates.lowest();
+            } else {
+                values[pos] = 0;
+                solved = false;
+            }
+        }
+        propagatedBoards[lane] = Board::fromValues(values);
+        outcomes[lane] = solved ? Outcome::Solved : Outcome::NeedsSearch;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef LOCKSTEP_PROPAGATOR_H
+#define LOCKSTEP_PROPAGATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "board.h"
+
+namespace sudoku {
+
+/**
+ * @brief Propagates naked and hidden singles on several 9x9 boards at once.
+ *
+ * The candidates of the boards are kept as bit masks laid out position-major
+ * with one lane per board, so each step of the propagation runs over all the
+ * lanes in the same loop and is compiled to vector instructions. The kernel
+ * is built for AVX2 as well as for the baseline instruction set and the
+ * variant to run is picked at runtime, where the compiler supports it.
+ *
+ * Boards that propagation alone doesn't solve or refute are left for a
+ * searching engine, with the values propagation fixed filled in.
+ */
+class LockstepPropagator {
+   public:
+    // Number of boards propagated at once - 16 masks of 16 bits fill an AVX2
+    // register.
+    static const std::size_t NUM_LANES = 16;
+
+    enum class Outcome : std::uint8_t {
+        // Every position got a value.
+        Solved,
+        // A position or a value of a unit ran out of candidates.
+        NoSolution,
+        // Propagation got stuck - the board needs a search.
+        NeedsSearch
+    };
+
+    /**
+     * @brief Propagates singles on a group of valid boards.
+     *
+     * @param boards the boards to be propagated - at most NUM_LANES.
+     * @param numBoards the number of boards in the group.
+     * @param propagatedBoards receives the solution of each board whose
+     * outcome is Outcome::Solved and the board with the values fixed by
+     * propagation of each board whose outcome is Outcome::NeedsSearch - left
+     * untouched for the others.
+     * @param outcomes receives the outcome of each board.
+     */
+    void propagate(const Board *boards, std::size_t numBoards,
+                   Board *propagatedBoards, Outcome *outcomes) noexcept;
+
+   private:
+    // Candidates of each position in each lane - the scratch buffer the
+    // kernel loads from and stores to.
+    alignas(32) std::uint16_t _candidates[Board::NUM_POS][NUM_LANES]{};
+    // Non zero for the lanes found without solution.
+    std::uint16_t _failed[NUM_LANES]{};
+};
+
+}  // namespace sudoku
+
+#endif
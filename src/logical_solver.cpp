@@ -0,0 +1,635 @@
+#include "logical_solver.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+#include "candidate_set.h"
+#include "unit_tables.h"
+
+using namespace std;
+using namespace sudoku;
+
+namespace {
+
+const uint16_t ALL_VALUES = CandidateSet::ALL_MASK;
+const uint8_t UNIT_SIZE = UnitTables::UNIT_SIZE;
+const uint8_t FIRST_SECTION = Board::NUM_ROWS + Board::NUM_COLS;
+
+// Each step places a value or eliminates at least one candidate.
+const size_t MAX_STEPS = Board::NUM_POS + Board::NUM_POS * Board::MAX_VAL;
+
+constexpr uint16_t valueBit(uint8_t value) noexcept {
+    return static_cast<uint16_t>(1U << (value - 1U));
+}
+
+inline uint8_t bitCount(uint16_t mask) noexcept {
+    return CandidateSet(mask).size();
+}
+
+inline bool sees(uint8_t pos, uint8_t other) noexcept {
+    const uint8_t *units = UNIT_TABLES.posUnits[pos];
+    const uint8_t *otherUnits = UNIT_TABLES.posUnits[other];
+    return pos != other &&
+           (units[0] == otherUnits[0] || units[1] == otherUnits[1] ||
+            units[2] == otherUnits[2]);
+}
+
+/**
+ * @brief Visits the subsets of a given size of a list of masks whose union
+ * has exactly that size - N items with N bits between them.
+ *
+ * @param masks the masks of the items.
+ * @param numMasks the number of items.
+ * @param size the size of the subsets - at most 4.
+ * @param visit called with the mask of the items in the subset (bit i for
+ * item i) and their union; returning true stops the enumeration.
+ * @return whether visit stopped the enumeration.
+ */
+template <typename Visitor>
+bool forEachSubset(const uint16_t *masks, uint8_t numMasks, uint8_t size,
+                   Visitor &&visit) {
+    uint8_t items[4]{};
+    uint16_t unions[5]{};
+    int depth = 0;
+    while (depth >= 0) {
+        if (items[depth] >= numMasks) {
+            // All the items tried at this depth.
+            depth--;
+            if (depth >= 0) {
+                items[depth]++;
+            }
+            continue;
+        }
+        const uint16_t united =
+            static_cast<uint16_t>(unions[depth] | masks[items[depth]]);
+        if (bitCount(united) > size) {
+            // No superset can have fewer bits.
+            items[depth]++;
+            continue;
+        }
+        if (depth + 1 < size) {
+            unions[depth + 1] = united;
+            items[depth + 1] = static_cast<uint8_t>(items[depth] + 1);
+            depth++;
+            continue;
+        }
+        if (bitCount(united) == size) {
+            uint16_t subset = 0;
+            for (uint8_t i = 0; i < size; i++) {
+                subset |= static_cast<uint16_t>(1U << items[i]);
+            }
+            if (visit(subset, united)) {
+                return true;
+            }
+        }
+        items[depth]++;
+    }
+    return false;
+}
+
+}  // namespace
+
+LogicalSolver::LogicalSolver() { _steps.reserve(MAX_STEPS); }
+
+LogicalResult LogicalSolver::solve(const Board &board) {
+    if (!load(board)) {
+        return LogicalResult::InvalidBoard;
+    }
+    while (!_contradiction && _numBlanks > 0 && step() > 0) {
+    }
+    if (_contradiction) {
+        return LogicalResult::HasNoSolution;
+    }
+    return _numBlanks == 0 ? LogicalResult::Solved : LogicalResult::Stuck;
+}
+
+bool LogicalSolver::load(const Board &board) {
+    _steps.clear();
+    for (auto &timesUsed : _timesUsed) {
+        timesUsed = 0;
+    }
+    _hardest = Technique::NakedSingle;
+    _contradiction = false;
+    if (!board.isValid()) {
+        return false;
+    }
+
+    for (auto &unitMask : _unitMasks) {
+        unitMask = 0;
+    }
+    _numBlanks = 0;
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        _values[pos] =
+            board.valueAt(pos / Board::NUM_COLS, pos % Board::NUM_COLS);
+        if (_values[pos] == 0) {
+            _numBlanks++;
+            continue;
+        }
+        for (const uint8_t unit : UNIT_TABLES.posUnits[pos]) {
+            _unitMasks[unit] |= valueBit(_values[pos]);
+        }
+    }
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        const uint8_t *units = UNIT_TABLES.posUnits[pos];
+        _candidates[pos] =
+            _values[pos] != 0
+                ? 0
+                : static_cast<uint16_t>(
+                      ALL_VALUES & ~(_unitMasks[units[0]] |
+                                     _unitMasks[units[1]] |
+                                     _unitMasks[units[2]]));
+    }
+    _contradiction = findContradiction();
+    return true;
+}
+
+size_t LogicalSolver::step() {
+    if (_contradiction || _numBlanks == 0) {
+        return 0;
+    }
+    const size_t numSteps = _steps.size();
+    const bool progress =
+        nakedSingles() || hiddenSingles() || lockedCandidates() ||
+        nakedSubsets(2, Technique::NakedPair) ||
+        hiddenSubsets(2, Technique::HiddenPair) ||
+        nakedSubsets(3, Technique::NakedTriple) ||
+        hiddenSubsets(3, Technique::HiddenTriple) ||
+        nakedSubsets(4, Technique::NakedQuad) ||
+        hiddenSubsets(4, Technique::HiddenQuad) ||
+        fish(2, Technique::XWing) || fish(3, Technique::Swordfish) ||
+        xyWing() || simpleColoring();
+    if (progress) {
+        _contradiction = findContradiction();
+    }
+    return _steps.size() - numSteps;
+}
+
+Board LogicalSolver::board() const noexcept {
+    return Board::fromValues(_values);
+}
+
+bool LogicalSolver::nakedSingles() {
+    bool progress = false;
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        const CandidateSet candidates(_candidates[pos]);
+        if (candidates.size() == 1) {
+            const size_t firstStep = _steps.size();
+            place(pos, candidates.lowest(), Technique::NakedSingle);
+            progress |= finishApplication(firstStep, Technique::NakedSingle);
+        }
+    }
+    return progress;
+}
+
+bool LogicalSolver::hiddenSingles() {
+    for (uint8_t unit = 0; unit < Board::NUM_UNITS; unit++) {
+        uint16_t once = 0;
+        uint16_t twice = 0;
+        for (const uint8_t pos : UNIT_TABLES.units[unit]) {
+            twice |= once & _candidates[pos];
+            once |= _candidates[pos];
+        }
+        CandidateSet singles(static_cast<uint16_t>(once & ~twice));
+        bool progress = false;
+        while (!singles.empty()) {
+            const uint8_t value = singles.popLowest();
+            for (const uint8_t pos : UNIT_TABLES.units[unit]) {
+                // The position may have taken another hidden single of the
+                // unit in the meantime.
+                if ((_candidates[pos] & valueBit(value)) != 0) {
+                    const size_t firstStep = _steps.size();
+                    place(pos, value, Technique::HiddenSingle);
+                    progress |=
+                        finishApplication(firstStep, Technique::HiddenSingle);
+                    break;
+                }
+            }
+        }
+        if (progress) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LogicalSolver::lockedCandidates() {
+    // Each section intersects three lines and three columns; the candidates
+    // of a value in the intersection that are nowhere else in one of the
+    // units are eliminated from the rest of the other unit.
+    for (uint8_t sec = 0; sec < Board::NUM_ROWS; sec++) {
+        const uint8_t secUnit = FIRST_SECTION + sec;
+        for (uint8_t k = 0; k < 6; k++) {
+            const uint8_t lineUnit =
+                k < 3 ? static_cast<uint8_t>(sec / 3 * 3 + k)
+                      : static_cast<uint8_t>(Board::NUM_ROWS + sec % 3 * 3 +
+                                             k - 3);
+            const uint8_t lineIdx = k < 3 ? 0 : 1;
+            uint16_t inside = 0;
+            uint16_t lineRest = 0;
+            uint16_t secRest = 0;
+            for (const uint8_t pos : UNIT_TABLES.units[lineUnit]) {
+                if (UNIT_TABLES.posUnits[pos][2] == secUnit) {
+                    inside |= _candidates[pos];
+                } else {
+                    lineRest |= _candidates[pos];
+                }
+            }
+            for (const uint8_t pos : UNIT_TABLES.units[secUnit]) {
+                if (UNIT_TABLES.posUnits[pos][lineIdx] != lineUnit) {
+                    secRest |= _candidates[pos];
+                }
+            }
+            // Pointing - values of the section locked in the line.
+            const uint16_t pointing =
+                static_cast<uint16_t>(inside & ~secRest & lineRest);
+            // Claiming - values of the line locked in the section.
+            const uint16_t claiming =
+                static_cast<uint16_t>(inside & ~lineRest & secRest);
+            if (pointing == 0 && claiming == 0) {
+                continue;
+            }
+            const size_t firstStep = _steps.size();
+            for (const uint8_t pos : UNIT_TABLES.units[lineUnit]) {
+                if (UNIT_TABLES.posUnits[pos][2] != secUnit) {
+                    eliminate(pos, pointing, Technique::LockedCandidates);
+                }
+            }
+            for (const uint8_t pos : UNIT_TABLES.units[secUnit]) {
+                if (UNIT_TABLES.posUnits[pos][lineIdx] != lineUnit) {
+                    eliminate(pos, claiming, Technique::LockedCandidates);
+                }
+            }
+            if (finishApplication(firstStep, Technique::LockedCandidates)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool LogicalSolver::nakedSubsets(uint8_t size, Technique technique) {
+    for (uint8_t unit = 0; unit < Board::NUM_UNITS; unit++) {
+        // The blanks of the unit with at most size candidates.
+        uint8_t cells[UNIT_SIZE];
+        uint16_t masks[UNIT_SIZE];
+        uint8_t numCells = 0;
+        uint8_t numBlanks = 0;
+        for (const uint8_t pos : UNIT_TABLES.units[unit]) {
+            if (_candidates[pos] == 0) {
+                continue;
+            }
+            numBlanks++;
+            if (bitCount(_candidates[pos]) <= size) {
+                cells[numCells] = pos;
+                masks[numCells++] = _candidates[pos];
+            }
+        }
+        if (numBlanks <= size) {
+            continue;
+        }
+        const bool progress = forEachSubset(
+            masks, numCells, size, [&](uint16_t subset, uint16_t values) {
+                const size_t firstStep = _steps.size();
+                for (const uint8_t pos : UNIT_TABLES.units[unit]) {
+                    bool inSubset = false;
+                    for (uint8_t i = 0; i < numCells; i++) {
+                        inSubset |= cells[i] == pos && (subset >> i & 1U) != 0;
+                    }
+                    if (!inSubset) {
+                        eliminate(pos, values, technique);
+                    }
+                }
+                return finishApplication(firstStep, technique);
+            });
+        if (progress) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LogicalSolver::hiddenSubsets(uint8_t size, Technique technique) {
+    for (uint8_t unit = 0; unit < Board::NUM_UNITS; unit++) {
+        const uint8_t *positions = UNIT_TABLES.units[unit];
+        // The values missing from the unit with at most size positions, each
+        // one with the mask of its positions in the unit.
+        uint8_t values[Board::MAX_VAL];
+        uint16_t masks[Board::MAX_VAL];
+        uint8_t numValues = 0;
+        uint8_t numMissing = 0;
+        for (uint8_t value = 1; value <= Board::MAX_VAL; value++) {
+            if ((_unitMasks[unit] & valueBit(value)) != 0) {
+                continue;
+            }
+            numMissing++;
+            uint16_t valuePositions = 0;
+            for (uint8_t i = 0; i < UNIT_SIZE; i++) {
+                if ((_candidates[positions[i]] & valueBit(value)) != 0) {
+                    valuePositions |= static_cast<uint16_t>(1U << i);
+                }
+            }
+            // Values with a single position are hidden singles.
+            const uint8_t numPositions = bitCount(valuePositions);
+            if (numPositions >= 2 && numPositions <= size) {
+                values[numValues] = value;
+                masks[numValues++] = valuePositions;
+            }
+        }
+        if (numMissing <= size) {
+            continue;
+        }
+        const bool progress = forEachSubset(
+            masks, numValues, size, [&](uint16_t subset, uint16_t cells) {
+                uint16_t kept = 0;
+                for (uint8_t i = 0; i < numValues; i++) {
+                    if ((subset >> i & 1U) != 0) {
+                        kept |= valueBit(values[i]);
+                    }
+                }
+                const size_t firstStep = _steps.size();
+                for (uint8_t i = 0; i < UNIT_SIZE; i++) {
+                    if ((cells >> i & 1U) != 0) {
+                        eliminate(positions[i],
+                                  static_cast<uint16_t>(ALL_VALUES & ~kept),
+                                  technique);
+                    }
+                }
+                return finishApplication(firstStep, technique);
+            });
+        if (progress) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LogicalSolver::fish(uint8_t size, Technique technique) {
+    for (uint8_t value = 1; value <= Board::MAX_VAL; value++) {
+        const uint16_t bit = valueBit(value);
+        // Lines as base units and columns as cover units, then the reverse.
+        for (uint8_t base = 0; base < 2; base++) {
+            const uint8_t firstBase = base == 0 ? 0 : Board::NUM_ROWS;
+            const uint8_t firstCover = base == 0 ? Board::NUM_ROWS : 0;
+            uint8_t units[Board::NUM_ROWS];
+            uint16_t masks[Board::NUM_ROWS];
+            uint8_t numUnits = 0;
+            for (uint8_t i = 0; i < Board::NUM_ROWS; i++) {
+                const uint8_t unit = firstBase + i;
+                uint16_t covers = 0;
+                for (uint8_t j = 0; j < UNIT_SIZE; j++) {
+                    if ((_candidates[UNIT_TABLES.units[unit][j]] & bit) != 0) {
+                        covers |= static_cast<uint16_t>(1U << j);
+                    }
+                }
+                // Units with the value placed or with a single position left
+                // for it are not fish material.
+                const uint8_t numCovers = bitCount(covers);
+                if (numCovers >= 2 && numCovers <= size) {
+                    units[numUnits] = unit;
+                    masks[numUnits++] = covers;
+                }
+            }
+            const bool progress = forEachSubset(
+                masks, numUnits, size, [&](uint16_t subset, uint16_t covers) {
+                    const size_t firstStep = _steps.size();
+                    CandidateSet coverSet(covers);
+                    while (!coverSet.empty()) {
+                        const uint8_t cover = static_cast<uint8_t>(
+                            firstCover + coverSet.popLowest() - 1);
+                        for (uint8_t j = 0; j < UNIT_SIZE; j++) {
+                            const uint8_t pos = UNIT_TABLES.units[cover][j];
+                            const uint8_t posBase =
+                                UNIT_TABLES.posUnits[pos][base];
+                            bool inBase = false;
+                            for (uint8_t i = 0; i < numUnits; i++) {
+                                inBase |= units[i] == posBase &&
+                                          (subset >> i & 1U) != 0;
+                            }
+                            if (!inBase) {
+                                eliminate(pos, bit, technique);
+                            }
+                        }
+                    }
+                    return finishApplication(firstStep, technique);
+                });
+            if (progress) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool LogicalSolver::xyWing() {
+    for (uint8_t pivot = 0; pivot < Board::NUM_POS; pivot++) {
+        const uint16_t pivotValues = _candidates[pivot];
+        if (bitCount(pivotValues) != 2) {
+            continue;
+        }
+        for (const uint8_t first : UNIT_TABLES.peers[pivot]) {
+            const uint16_t firstValues = _candidates[first];
+            const uint16_t shared = firstValues & pivotValues;
+            if (bitCount(firstValues) != 2 || bitCount(shared) != 1) {
+                continue;
+            }
+            // The pincers are {x, z} and {y, z} for a pivot {x, y}.
+            const uint16_t z = firstValues & ~pivotValues;
+            const uint16_t secondValues =
+                static_cast<uint16_t>((pivotValues & ~shared) | z);
+            for (const uint8_t second : UNIT_TABLES.peers[pivot]) {
+                if (second <= first || _candidates[second] != secondValues) {
+                    continue;
+                }
+                const size_t firstStep = _steps.size();
+                for (const uint8_t pos : UNIT_TABLES.peers[first]) {
+                    if (pos != second && sees(pos, second)) {
+                        eliminate(pos, z, Technique::XYWing);
+                    }
+                }
+                if (finishApplication(firstStep, Technique::XYWing)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool LogicalSolver::simpleColoring() {
+    for (uint8_t value = 1; value <= Board::MAX_VAL; value++) {
+        const uint16_t bit = valueBit(value);
+        // The other position of the conjugate pair of each unit - the units
+        // with exactly two positions for the value.
+        uint8_t conjugates[Board::NUM_UNITS][2];
+        bool isPair[Board::NUM_UNITS]{};
+        for (uint8_t unit = 0; unit < Board::NUM_UNITS; unit++) {
+            uint8_t numPositions = 0;
+            for (const uint8_t pos : UNIT_TABLES.units[unit]) {
+                if ((_candidates[pos] & bit) != 0) {
+                    if (numPositions < 2) {
+                        conjugates[unit][numPositions] = pos;
+                    }
+                    numPositions++;
+                }
+            }
+            isPair[unit] = numPositions == 2;
+        }
+
+        // Colors of the positions of the current chain are 1 and 2; 0 is no
+        // color. The positions of the chains already processed are only
+        // marked as visited, as they can still see both colors of another
+        // chain.
+        uint8_t colors[Board::NUM_POS]{};
+        bool visited[Board::NUM_POS]{};
+        for (uint8_t start = 0; start < Board::NUM_POS; start++) {
+            if ((_candidates[start] & bit) == 0 || visited[start]) {
+                continue;
+            }
+            // Colors the chain of start, breadth first.
+            uint8_t chain[Board::NUM_POS];
+            uint8_t chainSize = 0;
+            chain[chainSize++] = start;
+            colors[start] = 1;
+            visited[start] = true;
+            for (uint8_t i = 0; i < chainSize; i++) {
+                const uint8_t pos = chain[i];
+                for (const uint8_t unit : UNIT_TABLES.posUnits[pos]) {
+                    if (!isPair[unit]) {
+                        continue;
+                    }
+                    const uint8_t other = conjugates[unit][0] == pos
+                                              ? conjugates[unit][1]
+                                              : conjugates[unit][0];
+                    if (!visited[other]) {
+                        colors[other] = static_cast<uint8_t>(3 - colors[pos]);
+                        visited[other] = true;
+                        chain[chainSize++] = other;
+                    }
+                }
+            }
+            if (chainSize < 2) {
+                // A position without conjugate pairs.
+                colors[start] = 0;
+                continue;
+            }
+
+            const size_t firstStep = _steps.size();
+            // Color wrap - a color seen twice in a unit is false.
+            uint8_t falseColor = 0;
+            for (uint8_t i = 0; i < chainSize && falseColor == 0; i++) {
+                for (uint8_t j = i + 1; j < chainSize; j++) {
+                    if (colors[chain[i]] == colors[chain[j]] &&
+                        sees(chain[i], chain[j])) {
+                        falseColor = colors[chain[i]];
+                        break;
+                    }
+                }
+            }
+            if (falseColor != 0) {
+                for (uint8_t i = 0; i < chainSize; i++) {
+                    if (colors[chain[i]] == falseColor) {
+                        eliminate(chain[i], bit, Technique::SimpleColoring);
+                    }
+                }
+            } else {
+                // Color trap - a position that sees both colors can't have
+                // the value.
+                for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+                    if ((_candidates[pos] & bit) == 0 || colors[pos] != 0) {
+                        continue;
+                    }
+                    uint8_t seenColors = 0;
+                    for (uint8_t i = 0; i < chainSize; i++) {
+                        if (sees(pos, chain[i])) {
+                            seenColors |= colors[chain[i]];
+                        }
+                    }
+                    if (seenColors == 3) {
+                        eliminate(pos, bit, Technique::SimpleColoring);
+                    }
+                }
+            }
+            if (finishApplication(firstStep, Technique::SimpleColoring)) {
+                return true;
+            }
+            for (uint8_t i = 0; i < chainSize; i++) {
+                colors[chain[i]] = 0;
+            }
+        }
+    }
+    return false;
+}
+
+bool LogicalSolver::setValue(uint8_t line, uint8_t column, uint8_t value) {
+    const auto pos = static_cast<uint8_t>(line * Board::NUM_COLS + column);
+    if (value == 0 || value > Board::MAX_VAL ||
+        (_candidates[pos] & valueBit(value)) == 0) {
+        return false;
+    }
+    assign(pos, value);
+    if (!_contradiction) {
+        _contradiction = findContradiction();
+    }
+    return true;
+}
+
+void LogicalSolver::place(uint8_t pos, uint8_t value, Technique technique) {
+    _steps.push_back({technique, true, false, pos, value});
+    assign(pos, value);
+}
+
+void LogicalSolver::assign(uint8_t pos, uint8_t value) noexcept {
+    const uint16_t bit = valueBit(value);
+    _values[pos] = value;
+    _candidates[pos] = 0;
+    _numBlanks--;
+    for (const uint8_t unit : UNIT_TABLES.posUnits[pos]) {
+        _unitMasks[unit] |= bit;
+    }
+    for (const uint8_t peer : UNIT_TABLES.peers[pos]) {
+        _candidates[peer] &= static_cast<uint16_t>(~bit);
+    }
+}
+
+bool LogicalSolver::eliminate(uint8_t pos, uint16_t values,
+                              Technique technique) {
+    const uint16_t eliminated = _candidates[pos] & values;
+    if (eliminated == 0) {
+        return false;
+    }
+    _steps.push_back({technique, false, false, pos, eliminated});
+    _candidates[pos] &= static_cast<uint16_t>(~eliminated);
+    return true;
+}
+
+bool LogicalSolver::finishApplication(size_t firstStep, Technique technique) {
+    if (_steps.size() == firstStep) {
+        return false;
+    }
+    _steps[firstStep].first = true;
+    _timesUsed[static_cast<size_t>(technique)]++;
+    if (technique > _hardest) {
+        _hardest = technique;
+    }
+    return true;
+}
+
+bool LogicalSolver::findContradiction() const noexcept {
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        if (_values[pos] == 0 && _candidates[pos] == 0) {
+            return true;
+        }
+    }
+    for (uint8_t unit = 0; unit < Board::NUM_UNITS; unit++) {
+        uint16_t values = _unitMasks[unit];
+        for (const uint8_t pos : UNIT_TABLES.units[unit]) {
+            values |= _candidates[pos];
+        }
+        if (values != ALL_VALUES) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,223 @@
+#ifndef LOGICAL_SOLVER_H
+#define LOGICAL_SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+
+namespace sudoku {
+
+/**
+ * @brief The deduction techniques of the logical solver, in the order they
+ * are tried - from the cheapest to the most expensive.
+ */
+enum class Technique : uint8_t {
+    // A position with a single candidate.
+    NakedSingle,
+    // A value with a single possible position in a unit.
+    HiddenSingle,
+    // The candidates of a value in a unit all lie in another unit.
+    LockedCandidates,
+    // N positions of a unit with N candidates between them.
+    NakedPair,
+    // N values of a unit with N possible positions between them.
+    HiddenPair,
+    NakedTriple,
+    HiddenTriple,
+    NakedQuad,
+    HiddenQuad,
+    // N lines (or columns) whose candidates of a value lie in N columns (or
+    // lines).
+    XWing,
+    Swordfish,
+    // A bivalue pivot whose two bivalue pincers share a candidate.
+    XYWing,
+    // Two coloring of the positions linked by the conjugate pairs of a value.
+    SimpleColoring
+};
+
+const std::size_t NUM_TECHNIQUES =
+    static_cast<std::size_t>(Technique::SimpleColoring) + 1;
+
+enum class LogicalResult : uint8_t {
+    // Every position got a value.
+    Solved,
+    // No technique applies anymore - the board needs guessing or has more
+    // than one solution.
+    Stuck,
+    InvalidBoard,
+    // A position or a value of a unit ran out of candidates.
+    HasNoSolution
+};
+
+/**
+ * @brief A record of the step trace of the logical solver: a value placed at
+ * a position or candidates eliminated from a position.
+ *
+ * A technique that eliminates candidates from several positions at once
+ * records one step per position, all with the first flag set only in the
+ * first of them.
+ */
+struct LogicalStep {
+    Technique technique;
+    // Whether the step places a value - otherwise it eliminates candidates.
+    bool placement;
+    // Whether the step is the first one of an application of the technique.
+    bool first;
+    std::uint8_t pos;
+    // The value placed, or the bit mask of the candidates eliminated - bit 0
+    // for value 1.
+    std::uint16_t values;
+};
+
+/**
+ * @brief Solves 9x9 boards with the deduction techniques used by people,
+ * without guessing.
+ *
+ * The candidates of the board are kept as a grid of bit masks. After each
+ * application of a technique the techniques are tried again from the
+ * cheapest one, so the hardest technique used is the hardest one the board
+ * really needs. Every deduction is recorded in a step trace, preallocated
+ * with the solver, so solving makes no allocations.
+ */
+class LogicalSolver {
+   public:
+    LogicalSolver();
+
+    /**
+     * @brief Solves a board as far as the techniques allow.
+     *
+     * @param board the board to be solved.
+     * @return the result of the solving - the board reached is available
+     * through board().
+     */
+    LogicalResult solve(const Board &board);
+
+    /**
+     * @brief Loads a board, computing the candidates of its positions and
+     * clearing the step trace.
+     *
+     * @return false if the board is invalid.
+     */
+    bool load(const Board &board);
+
+    /**
+     * @brief Applies the cheapest technique that makes progress on the board
+     * loaded.
+     *
+     * @return the number of steps recorded - 0 if no technique applies or a
+     * contradiction has been found.
+     */
+    std::size_t step();
+
+    /**
+     * @brief Places a value found outside the solver, such as one entered by
+     * a player, on the board loaded. The placement is not recorded in the
+     * step trace.
+     *
+     * @return false if the value is not a candidate of the position - the
+     * board is left unchanged.
+     */
+    bool setValue(std::uint8_t line, std::uint8_t column, std::uint8_t value);
+
+    /**
+     * @brief The board with the values placed so far.
+     */
+    Board board() const noexcept;
+
+    /**
+     * @brief The candidates left at a position - empty for filled positions.
+     */
+    CandidateSet candidates(std::uint8_t line,
+                            std::uint8_t column) const noexcept {
+        return CandidateSet(_candidates[line * Board::NUM_COLS + column]);
+    }
+
+    /**
+     * @brief The steps taken since the board was loaded.
+     */
+    const std::vector<LogicalStep> &steps() const noexcept { return _steps; }
+
+    /**
+     * @brief The number of applications of a technique since the board was
+     * loaded.
+     */
+    unsigned timesUsed(Technique technique) const noexcept {
+        return _timesUsed[static_cast<std::size_t>(technique)];
+    }
+
+    /**
+     * @brief The hardest technique applied since the board was loaded -
+     * NakedSingle if none was.
+     */
+    Technique hardestTechnique() const noexcept { return _hardest; }
+
+    /**
+     * @brief Whether a contradiction has been found on the board loaded.
+     */
+    bool contradiction() const noexcept { return _contradiction; }
+
+    /**
+     * @brief Whether every position of the board loaded has a value.
+     */
+    bool solved() const noexcept { return _numBlanks == 0; }
+
+   private:
+    bool nakedSingles();
+    bool hiddenSingles();
+    bool lockedCandidates();
+    bool nakedSubsets(std::uint8_t size, Technique technique);
+    bool hiddenSubsets(std::uint8_t size, Technique technique);
+    bool fish(std::uint8_t size, Technique technique);
+    bool xyWing();
+    bool simpleColoring();
+
+    /**
+     * @brief Places a value and takes it off the candidates of the peers of
+     * the position.
+     */
+    void place(std::uint8_t pos, std::uint8_t value, Technique technique);
+
+    /**
+     * @brief Sets a value at a position and takes it off the candidates of
+     * the peers of the position - the part of place not recorded.
+     */
+    void assign(std::uint8_t pos, std::uint8_t value) noexcept;
+
+    /**
+     * @brief Eliminates candidates from a position - returns false if none
+     * of them was a candidate.
+     */
+    bool eliminate(std::uint8_t pos, std::uint16_t values,
+                   Technique technique);
+
+    /**
+     * @brief Accounts for an application of a technique whose steps start
+     * at a given index of the trace - returns false if it recorded no step.
+     */
+    bool finishApplication(std::size_t firstStep, Technique technique);
+
+    /**
+     * @brief Looks for a blank position without candidates or a value
+     * without positions in a unit.
+     */
+    bool findContradiction() const noexcept;
+
+    // Candidates of each position - 0 for filled positions.
+    std::uint16_t _candidates[Board::NUM_POS]{};
+    std::uint8_t _values[Board::NUM_POS]{};
+    // Values placed in each unit.
+    std::uint16_t _unitMasks[Board::NUM_UNITS]{};
+    std::uint8_t _numBlanks{0};
+    bool _contradiction{false};
+
+    std::vector<LogicalStep> _steps;
+    unsigned _timesUsed[NUM_TECHNIQUES]{};
+    Technique _hardest{Technique::NakedSingle};
+};
+
+}  // namespace sudoku
+
+#endif
@@ -0,0 +1,74 @@
+#include "packed_board.h"
+
+#include <cstring>
+
+#include "board.h"
+
+using namespace std;
+using namespace sudoku;
+
+namespace {
+
+const uint8_t NIBBLE_MASK = 0x0F;
+
+}  // namespace
+
+PackedBoard::PackedBoard(const Board &board) noexcept {
+    // Flat view of the board values; the loops below have no dependencies
+    // between iterations so they can be vectorized by the compiler.
+    const uint8_t *values = &board._values[0][0];
+    uint8_t clamped[NUM_BYTES * 2]{};
+    for (size_t i = 0; i < Board::NUM_POS; i++) {
+        clamped[i] = values[i] > NIBBLE_MASK ? NIBBLE_MASK : values[i];
+    }
+    for (size_t i = 0; i < NUM_BYTES; i++) {
+        _nibbles[i] =
+            static_cast<uint8_t>(clamped[2 * i] | (clamped[2 * i + 1] << 4U));
+    }
+}
+
+Board PackedBoard::unpack() const noexcept {
+    Board board;
+    uint8_t unpacked[NUM_BYTES * 2];
+    for (size_t i = 0; i < NUM_BYTES; i++) {
+        unpacked[2 * i] = _nibbles[i] & NIBBLE_MASK;
+        unpacked[2 * i + 1] = static_cast<uint8_t>(_nibbles[i] >> 4U);
+    }
+    memcpy(&board._values[0][0], unpacked, Board::NUM_POS);
+    board.rebuildUnits();
+    return board;
+}
+
+uint8_t PackedBoard::valueAt(uint8_t line, uint8_t column) const noexcept {
+    if (line >= Board::NUM_ROWS || column >= Board::NUM_COLS) {
+        return 0;
+    }
+    const size_t pos = static_cast<size_t>(line) * Board::NUM_COLS + column;
+    const uint8_t packed = _nibbles[pos / 2];
+    return (pos % 2 == 0) ? (packed & NIBBLE_MASK)
+                          : static_cast<uint8_t>(packed >> 4U);
+}
+
+size_t PackedBoard::hash() const noexcept {
+    // Consumes the 41 bytes as five 64-bit words plus a trailing byte, mixing
+    // each word with a multiply-xorshift step.
+    const uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+    const unsigned SHIFT = 29U;
+    uint64_t hashValue = NUM_BYTES;
+    size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= NUM_BYTES; offset += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        memcpy(&word, _nibbles + offset, sizeof(word));
+        hashValue = (hashValue ^ word) * MULTIPLIER;
+        hashValue ^= hashValue >> SHIFT;
+    }
+    for (; offset < NUM_BYTES; offset++) {
+        hashValue = (hashValue ^ _nibbles[offset]) * MULTIPLIER;
+        hashValue ^= hashValue >> SHIFT;
+    }
+    return static_cast<size_t>(hashValue);
+}
+
+bool PackedBoard::operator==(const PackedBoard &other) const noexcept {
+    return memcmp(_nibbles, other._nibbles, NUM_BYTES) == 0;
+}
@@ -0,0 +1,77 @@
+#ifndef PACKED_BOARD_H
+#define PACKED_BOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "board.h"
+
+namespace sudoku {
+
+/**
+ * @brief A compact representation of a Board meant for bulk storage.
+ *
+ * Two positions are stored per byte - the position with even index in the low
+ * nibble and the next position in the high nibble - so a board takes 41
+ * bytes instead of 81. Values above 15 (which are invalid anyway) are stored
+ * as 15, so an invalid board remains invalid after a pack/unpack round trip.
+ */
+class PackedBoard {
+   public:
+    static const std::size_t NUM_BYTES = (Board::NUM_POS + 1) / 2;
+
+    PackedBoard() = default;
+
+    explicit PackedBoard(const Board &board) noexcept;
+
+    /**
+     * @brief Unpacks the packed values into a regular Board.
+     */
+    Board unpack() const noexcept;
+
+    /**
+     * Retrieves the value at a given (line, column) coordinate of the
+     * packed board.
+     *
+     * @param line the line number (from 0 to 8).
+     * @param column the column number (from 0 to 8).
+     * @return the value at position (line, column) of the board - 0 for
+     * blank positions and for out-of-range coordinates.
+     */
+    std::uint8_t valueAt(std::uint8_t line, std::uint8_t column) const noexcept;
+
+    /**
+     * @brief A 64-bit hash computed directly over the packed bytes.
+     */
+    std::size_t hash() const noexcept;
+
+    const std::uint8_t *data() const noexcept { return _nibbles; }
+
+    bool operator==(const PackedBoard &other) const noexcept;
+
+    bool operator!=(const PackedBoard &other) const noexcept {
+        return !(*this == other);
+    }
+
+   private:
+    std::uint8_t _nibbles[NUM_BYTES]{};
+};
+
+static_assert(sizeof(PackedBoard) == PackedBoard::NUM_BYTES,
+              "PackedBoard must have no padding");
+
+}  // namespace sudoku
+
+namespace std {
+
+template <>
+struct hash<sudoku::PackedBoard> {
+    size_t operator()(const sudoku::PackedBoard &board) const noexcept {
+        return board.hash();
+    }
+};
+
+}  // namespace std
+
+#endif
@@ -0,0 +1,284 @@
+#include "parallel_search.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "board.h"
+#include "search_engine.h"
+
+using namespace std;
+using namespace sudoku;
+
+namespace {
+
+// Subtrees per thread - enough for the threads to balance their loads by
+// stealing.
+const size_t TASKS_PER_THREAD = 16;
+
+// Nodes a thread searches between attempts to report progress.
+const unsigned PROGRESS_INTERVAL = 4096;
+
+}  // namespace
+
+ParallelSearch::ParallelSearch(SolverEngine engine, unsigned numThreads)
+    : _engine(engine), _numThreads(max(numThreads, 1U)) {}
+
+unsigned ParallelSearch::defaultNumThreads() noexcept {
+    return max(thread::hardware_concurrency(), 1U);
+}
+
+vector<Board> ParallelSearch::search(const Board &board, unsigned maxSolutions,
+                                     const atomic<bool> &cancelled,
+                                     const ProgressCallback &onProgress) {
+    _countOnly = false;
+    run(board, maxSolutions, cancelled, onProgress);
+
+    size_t numSolutions = 0;
+    for (const auto &taskSolutions : _taskSolutions) {
+        numSolutions += taskSolutions.size();
+    }
+    vector<Board> solutions;
+    solutions.reserve(min<size_t>(numSolutions, maxSolutions));
+    if (solutions.capacity() > 0) {
+        _stats.solutionGrowths++;
+    }
+    for (const auto &taskSolutions : _taskSolutions) {
+        const size_t numTaken =
+            min(taskSolutions.size(), maxSolutions - solutions.size());
+        solutions.insert(solutions.end(), taskSolutions.begin(),
+                         taskSolutions.begin() + numTaken);
+    }
+    _taskSolutions.clear();
+    return solutions;
+}
+
+uint64_t ParallelSearch::count(const Board &board, uint64_t limit,
+                               const atomic<bool> &cancelled) {
+    _countOnly = true;
+    run(board, limit, cancelled, nullptr);
+    return min(_numFound.load(), limit);
+}
+
+void ParallelSearch::run(const Board &board, uint64_t maxSolutions,
+                         const atomic<bool> &cancelled,
+                         const ProgressCallback &onProgress) {
+    _stats = SolverStats();
+    _tasks = splitSearch(board, TASKS_PER_THREAD * _numThreads, _stats);
+    _splitDepth = _stats.maxDepth;
+    _queues = make_unique<TaskQueue[]>(_numThreads);
+    for (size_t task = 0; task < _tasks.size(); task++) {
+        // Each thread starts with a contiguous range of subtrees.
+        _queues[task * _numThreads / _tasks.size()].tasks.push_back(task);
+    }
+    _numTasksDone = 0;
+    _numFound = 0;
+    _maxSolutions = maxSolutions;
+    _cancelled = &cancelled;
+    _onProgress = &onProgress;
+    if (!_countOnly) {
+        _taskSolutions.assign(_tasks.size(), vector<Board>());
+        _taskCounts = make_unique<atomic<uint64_t>[]>(_tasks.size());
+    }
+
+    vector<thread> threads;
+    threads.reserve(_numThreads - 1);
+    for (unsigned worker = 1; worker < _numThreads; worker++) {
+        threads.emplace_back(&ParallelSearch::work, this, worker);
+    }
+    work(0);
+    for (auto &workerThread : threads) {
+        workerThread.join();
+    }
+
+    _tasks.clear();
+    _queues.reset();
+    _taskCounts.reset();
+}
+
+vector<Board> ParallelSearch::splitSearch(const Board &board, size_t minTasks,
+                                          SolverStats &stats) {
+    vector<Board> frontier{board};
+    bool expanded = true;
+    while (expanded && frontier.size() < minTasks) {
+        expanded = false;
+        vector<Board> next;
+        for (const Board &task : frontier) {
+            // Branches on the blank position with the fewest candidates, like
+            // the engines do.
+            uint8_t branchLin = 0;
+            uint8_t branchCol = 0;
+            uint8_t minSize = Board::MAX_VAL + 1;
+            for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+                for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+                    if (task.valueAt(lin, col) != 0) {
+                        continue;
+                    }
+                    const uint8_t size = task.getCandidates(lin, col).size();
+                    if (size < minSize) {
+                        branchLin = lin;
+                        branchCol = col;
+                        minSize = size;
+                    }
+                }
+            }
+            if (minSize == 0) {
+                // A blank position without candidates - no solution.
+                continue;
+            }
+            if (minSize > Board::MAX_VAL) {
+                // No blank position - the task is a solution itself.
+                next.push_back(task);
+                continue;
+            }
+            for (const uint8_t value :
+                 task.getCandidates(branchLin, branchCol)) {
+                Board child(task);
+                if (child.setValueAt(branchLin, branchCol, value) !=
+                    SetValueResult::NoError) {
+                    // Fails only on a board that was invalid to begin with -
+                    // the branch has no solution.
+                    continue;
+                }
+                next.push_back(child);
+                stats.nodes++;
+            }
+            expanded = true;
+        }
+        if (expanded) {
+            stats.maxDepth++;
+        }
+        frontier = std::move(next);
+    }
+    return frontier;
+}
+
+bool ParallelSearch::nextTask(unsigned worker, size_t &task) {
+    {
+        TaskQueue &own = _queues[worker];
+        lock_guard<mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    // Steals from the end of the other queues - the subtrees their owners
+    // would take last.
+    for (unsigned offset = 1; offset < _numThreads; offset++) {
+        TaskQueue &victim = _queues[(worker + offset) % _numThreads];
+        lock_guard<mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ParallelSearch::work(unsigned worker) {
+    const auto engine = createEngine(_engine);
+    {
+        lock_guard<mutex> lock(_statsMutex);
+        _stats.enginesCreated++;
+    }
+    SolverStats taskStats;
+    engine->setStats(&taskStats);
+
+    size_t task = 0;
+    // The solutions found before the subtree being searched, as last seen -
+    // it needs no more than the maximum less them.
+    uint64_t numBefore = 0;
+    uint32_t numGrowths = 0;
+    unsigned numNodes = 0;
+    const auto onSolution = [this, &task, &numBefore,
+                             &numGrowths](const Board &solution) {
+        vector<Board> &solutions = _taskSolutions[task];
+        if (solutions.size() == solutions.capacity()) {
+            numGrowths++;
+        }
+        solutions.push_back(solution);
+        _taskCounts[task] = solutions.size();
+        _numFound++;
+        return numBefore + solutions.size() < _maxSolutions;
+    };
+    const auto onProgress = [this, &task, &numBefore, &numNodes](double) {
+        if (++numNodes % PROGRESS_INTERVAL == 0) {
+            reportProgress();
+            if (!_countOnly) {
+                numBefore = foundBefore(task);
+                if (numBefore + _taskCounts[task] >= _maxSolutions) {
+                    return false;
+                }
+            }
+        }
+        return !shouldStop();
+    };
+
+    while (!shouldStop() && nextTask(worker, task)) {
+        if (_countOnly) {
+            // Each subtree is counted up to what was left of the limit when
+            // it was taken.
+            const uint64_t numFound = _numFound.load();
+            if (numFound < _maxSolutions) {
+                _numFound += engine->count(_tasks[task],
+                                           _maxSolutions - numFound, nullptr,
+                                           _cancelled);
+            }
+        } else {
+            numBefore = foundBefore(task);
+            if (numBefore < _maxSolutions) {
+                engine->search(_tasks[task], onSolution, onProgress);
+            }
+        }
+        if (SOLVER_STATS_ENABLED) {
+            // Subtrees start below the levels expanded by splitSearch.
+            taskStats.maxDepth += _splitDepth;
+            lock_guard<mutex> lock(_statsMutex);
+            mergeStats(_stats, taskStats);
+            taskStats = SolverStats();
+        }
+        _numTasksDone++;
+        reportProgress();
+    }
+    lock_guard<mutex> lock(_statsMutex);
+    _stats.solutionGrowths += numGrowths;
+}
+
+uint64_t ParallelSearch::foundBefore(size_t task) const noexcept {
+    uint64_t numFound = 0;
+    for (size_t before = 0; before < task; before++) {
+        numFound += _taskCounts[before];
+    }
+    return numFound;
+}
+
+void ParallelSearch::reportProgress() {
+    if (*_onProgress == nullptr) {
+        return;
+    }
+    // Threads that find another thread reporting just skip their report.
+    unique_lock<mutex> lock(_progressMutex, try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+    const double progressPercent =
+        _tasks.empty() ? 100.0
+                       : static_cast<double>(_numTasksDone) /
+                             static_cast<double>(_tasks.size()) * 100.0;
+    uint64_t numBacktracks = 0;
+    {
+        lock_guard<mutex> statsLock(_statsMutex);
+        numBacktracks = _stats.backtracks;
+    }
+    (*_onProgress)(progressPercent,
+                   static_cast<unsigned>(min(_numFound.load(), _maxSolutions)),
+                   numBacktracks);
+}
@@ -0,0 +1,158 @@
+#ifndef PARALLEL_SEARCH_H
+#define PARALLEL_SEARCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "board.h"
+#include "solver.h"
+
+namespace sudoku {
+
+/**
+ * @brief Enumerates the solutions of a board on several threads.
+ *
+ * The search tree is split at its first levels into subtrees - boards with
+ * some of the blank positions filled - that are shared among the threads.
+ * Each thread works through its own queue of subtrees and steals from the
+ * other queues once its queue is empty, so threads that draw small subtrees
+ * keep busy.
+ *
+ * Each subtree keeps its own solutions, and a search returns them in the
+ * order of the subtrees, so that the solutions returned don't depend on how
+ * the threads raced. A subtree is searched only for the solutions that the
+ * subtrees before it may not provide: a thread stops it once the solutions
+ * found before it and in it reach the maximum, and skips it if the ones
+ * before it already do. A count just shares an atomic count of solutions
+ * among the threads, which stop as soon as it reaches the limit.
+ */
+class ParallelSearch {
+   public:
+    // Receives the progress of the search, from 0 to 100, the number of
+    // solutions found so far and the dead ends of the subtrees searched so
+    // far. Calls are serialized.
+    using ProgressCallback = std::function<void(
+        double /* progressPercent */, unsigned /* numSolutions */,
+        std::uint64_t /* numBacktracks */)>;
+
+    /**
+     * @param engine the engine each thread searches its subtrees with.
+     * @param numThreads the number of threads to search with.
+     */
+    ParallelSearch(SolverEngine engine, unsigned numThreads);
+
+    /**
+     * @brief Searches for the solutions of a board.
+     *
+     * @param board the board to be solved.
+     * @param maxSolutions the maximum number of solutions to find.
+     * @param cancelled the flag that cancels the search when set.
+     * @param onProgress the optional callback for reporting progress.
+     * @return the solutions found, in the order of the subtrees they were
+     * found in - the first ones of that order, when there are more than
+     * maxSolutions. The order is the same on every search of the board with
+     * the same number of threads.
+     */
+    std::vector<Board> search(const Board &board, unsigned maxSolutions,
+                              const std::atomic<bool> &cancelled,
+                              const ProgressCallback &onProgress);
+
+    /**
+     * @brief Counts the solutions of a board, up to a limit, without keeping
+     * them.
+     *
+     * @param board the board to be solved.
+     * @param limit the count at which the search stops.
+     * @param cancelled the flag that cancels the search when set - checked
+     * within each subtree as well as between them.
+     * @return the number of solutions found, at most limit.
+     */
+    std::uint64_t count(const Board &board, std::uint64_t limit,
+                        const std::atomic<bool> &cancelled);
+
+    /**
+     * @brief The number of threads to be used by default - one per core.
+     */
+    static unsigned defaultNumThreads() noexcept;
+
+    /**
+     * @brief The statistics of the engines of the last search or count -
+     * the timings are left for the caller.
+     */
+    const SolverStats &stats() const noexcept { return _stats; }
+
+   private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    /**
+     * @brief Expands the first levels of the search tree of a board into
+     * at least minTasks subtrees, when the tree is that large.
+     *
+     * @param stats receives the nodes of the levels expanded and their
+     * number as the depth.
+     */
+    static std::vector<Board> splitSearch(const Board &board,
+                                          std::size_t minTasks,
+                                          SolverStats &stats);
+
+    /**
+     * @brief Splits the search of a board among the threads and waits for
+     * them to finish.
+     */
+    void run(const Board &board, std::uint64_t maxSolutions,
+             const std::atomic<bool> &cancelled,
+             const ProgressCallback &onProgress);
+
+    bool nextTask(unsigned worker, std::size_t &task);
+
+    void work(unsigned worker);
+
+    void reportProgress();
+
+    bool shouldStop() const noexcept {
+        return *_cancelled || (_countOnly && _numFound >= _maxSolutions);
+    }
+
+    /**
+     * @brief The solutions found so far by the subtrees before a given one -
+     * at most the number those subtrees end up with.
+     */
+    std::uint64_t foundBefore(std::size_t task) const noexcept;
+
+    SolverEngine _engine;
+    unsigned _numThreads;
+
+    // State of the current search, shared by the worker threads.
+    std::vector<Board> _tasks;
+    std::unique_ptr<TaskQueue[]> _queues;
+    std::atomic<std::size_t> _numTasksDone{0};
+    std::atomic<std::uint64_t> _numFound{0};
+    std::uint64_t _maxSolutions{0};
+    // Whether the solutions are only counted.
+    bool _countOnly{false};
+    const std::atomic<bool> *_cancelled{nullptr};
+    const ProgressCallback *_onProgress{nullptr};
+    // The solutions of each subtree, only added to by the thread searching
+    // it, and their number, read by the other threads.
+    std::vector<std::vector<Board>> _taskSolutions;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> _taskCounts;
+    std::mutex _progressMutex;
+    // Statistics of the engines, merged after each subtree.
+    std::mutex _statsMutex;
+    SolverStats _stats;
+    // Levels of the search tree expanded into subtrees.
+    std::uint32_t _splitDepth{0};
+};
+
+}  // namespace sudoku
+
+#endif
@@ -0,0 +1,97 @@
+#include "search_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "backtracking_engine.h"
+#include "bitboard_engine.h"
+#include "board.h"
+#include "dlx_engine.h"
+
+using namespace std;
+using namespace sudoku;
+
+namespace {
+
+// Minimum number of blank positions for the solutions of a board to be
+// enumerated or counted faster by the Dancing Links engine than by the
+// bitboard engine.
+const uint8_t DLX_MIN_BLANKS = 60;
+
+}  // namespace
+
+uint64_t SearchEngine::count(const Board &board, uint64_t limit,
+                             uint8_t *solution,
+                             const atomic<bool> *cancelled) {
+    uint64_t numSolutions = 0;
+    if (limit == 0) {
+        return numSolutions;
+    }
+    search(
+        board,
+        [&numSolutions, limit, solution](const Board &found) {
+            if (numSolutions == 0 && solution != nullptr) {
+                for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+                    solution[pos] = found.valueAt(pos / Board::NUM_COLS,
+                                                  pos % Board::NUM_COLS);
+                }
+            }
+            return ++numSolutions < limit;
+        },
+        [cancelled](double) {
+            return cancelled == nullptr || !cancelled->load();
+        });
+    return numSolutions;
+}
+
+void sudoku::mergeStats(SolverStats &total, const SolverStats &part) noexcept {
+    total.nodes += part.nodes;
+    total.backtracks += part.backtracks;
+    total.maxDepth = max(total.maxDepth, part.maxDepth);
+    total.eliminations += part.eliminations;
+    total.enginesCreated += part.enginesCreated;
+    total.solutionGrowths += part.solutionGrowths;
+}
+
+uint8_t sudoku::engineCapabilities(SolverEngine engine) noexcept {
+    switch (engine) {
+        case SolverEngine::Backtracking:
+            return BacktrackingEngine::CAPABILITIES;
+        case SolverEngine::DancingLinks:
+            return DlxEngine::CAPABILITIES;
+        default:
+            return BitboardEngine::CAPABILITIES;
+    }
+}
+
+SolverEngine sudoku::selectEngine(SolverEngine requested, const Board &board,
+                                  uint8_t required) noexcept {
+    if (requested != SolverEngine::Auto &&
+        (engineCapabilities(requested) & required) == required) {
+        return requested;
+    }
+    if ((required & SearchEngine::CandidateOrder) != 0) {
+        return SolverEngine::Backtracking;
+    }
+    if ((required & (SearchEngine::Enumeration | SearchEngine::Counting)) !=
+            0 &&
+        board.blankPositionCount() >= DLX_MIN_BLANKS) {
+        // Boards with few values have many solutions, which Dancing Links
+        // enumerates and counts faster.
+        return SolverEngine::DancingLinks;
+    }
+    return SolverEngine::Bitboard;
+}
+
+unique_ptr<SearchEngine> sudoku::createEngine(SolverEngine engine) {
+    switch (engine) {
+        case SolverEngine::Backtracking:
+            return make_unique<BacktrackingEngine>();
+        case SolverEngine::DancingLinks:
+            return make_unique<DlxEngine>();
+        default:
+            return make_unique<BitboardEngine>();
+    }
+}
@@ -0,0 +1,145 @@
+#ifndef SEARCH_ENGINE_H
+#define SEARCH_ENGINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "board.h"
+#include "solver.h"
+
+namespace sudoku {
+
+/**
+ * @brief The interface shared by the algorithms that search for the solutions
+ * of a 9x9 board.
+ *
+ * Engines don't check the boards they are given - an invalid board makes
+ * each of them fail in its own way. The Solver checks every board before
+ * picking an engine for it.
+ */
+class SearchEngine {
+   public:
+    // What an engine can do - combined as bit flags.
+    enum Capability : std::uint8_t {
+        // Finds a first solution.
+        FirstSolution = 0x01,
+        // Counts solutions without keeping them.
+        Counting = 0x02,
+        // Finds every solution, each one exactly once.
+        Enumeration = 0x04,
+        // Tries the values of a position in a given order.
+        CandidateOrder = 0x08
+    };
+
+    // Receives each solution found; returning false stops the search.
+    using SolutionCallback = std::function<bool(const Board & /* solution */)>;
+
+    // Receives the progress of the search, from 0 to 100, whenever the search
+    // branches; returning false stops the search.
+    using ProgressCallback = std::function<bool(double /* progressPercent */)>;
+
+    SearchEngine() = default;
+    SearchEngine(const SearchEngine &) = delete;
+    SearchEngine &operator=(const SearchEngine &) = delete;
+
+    virtual ~SearchEngine() = default;
+
+    /**
+     * @brief The capabilities of the engine, as a combination of Capability
+     * flags.
+     */
+    virtual std::uint8_t capabilities() const noexcept = 0;
+
+    /**
+     * @brief Searches for the solutions of a board.
+     *
+     * @param board the board to be solved - must be valid.
+     * @param onSolution the callback that receives each solution found.
+     * @param onProgress the optional callback that receives the progress of
+     * the search.
+     * @return the number of solutions found.
+     */
+    virtual unsigned search(const Board &board,
+                            const SolutionCallback &onSolution,
+                            const ProgressCallback &onProgress) = 0;
+
+    /**
+     * @brief Counts the solutions of a board, up to a limit, without building
+     * a Board for each of them.
+     *
+     * The default implementation counts the solutions found by search;
+     * engines with the Counting capability override it.
+     *
+     * @param board the board to be solved - must be valid.
+     * @param limit the count at which the search stops.
+     * @param solution if not null, receives the values of the first solution
+     * found, in line-major order - left untouched if there's no solution.
+     * @param cancelled if not null, the flag that stops the count when set -
+     * checked whenever the search branches.
+     * @return the number of solutions found, at most limit.
+     */
+    virtual std::uint64_t count(const Board &board, std::uint64_t limit,
+                                std::uint8_t *solution,
+                                const std::atomic<bool> *cancelled);
+
+    /**
+     * @brief Sets the order in which the values of a position are tried.
+     * Ignored by engines without the CandidateOrder capability.
+     *
+     * @param candidates the values from 1 to 9, without repetition.
+     */
+    virtual void setCandidateOrder(const std::uint8_t * /* candidates */) {}
+
+    /**
+     * @brief Sets the statistics the next searches add their counts to -
+     * nullptr, the default, stops the counting.
+     */
+    void setStats(SolverStats *stats) noexcept { _stats = stats; }
+
+   protected:
+    /**
+     * @brief Whether the search must count its statistics - a constant false
+     * when the counting is compiled away.
+     */
+    bool counting() const noexcept {
+        return SOLVER_STATS_ENABLED && _stats != nullptr;
+    }
+
+    SolverStats *_stats{nullptr};
+};
+
+/**
+ * @brief Adds the counts of the statistics of part of a search to the ones
+ * of the whole search - the timings are left for the caller.
+ */
+void mergeStats(SolverStats &total, const SolverStats &part) noexcept;
+
+/**
+ * @brief The capabilities of a given engine.
+ */
+std::uint8_t engineCapabilities(SolverEngine engine) noexcept;
+
+/**
+ * @brief Resolves the engine to be used for solving a board.
+ *
+ * @param requested the engine requested in the SolverOptions. Auto, or an
+ * engine that lacks any of the required capabilities, is resolved to the
+ * engine expected to be the fastest for the board.
+ * @param board the board to be solved - must be valid.
+ * @param required the capabilities the engine must have.
+ * @return the engine to be used - never SolverEngine::Auto.
+ */
+SolverEngine selectEngine(SolverEngine requested, const Board &board,
+                          std::uint8_t required) noexcept;
+
+/**
+ * @brief Creates an engine of a given kind - SolverEngine::Auto creates the
+ * bitboard engine.
+ */
+std::unique_ptr<SearchEngine> createEngine(SolverEngine engine);
+
+}  // namespace sudoku
+
+#endif
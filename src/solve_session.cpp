@@ -0,0 +1,109 @@
+#include "solve_session.h"
+
+#include <cstdint>
+
+#include "board.h"
+#include "search_engine.h"
+#include "solver.h"
+
+using namespace std;
+using namespace sudoku;
+
+SolveSession::SolveSession(const Board &board)
+    : _engine(createEngine(SolverEngine::Bitboard)) {
+    reset(board);
+}
+
+SolveSession::~SolveSession() = default;
+
+SolverResult SolveSession::reset(const Board &board) {
+    _board = board;
+    _solution = Board();
+    _numSearches = 0;
+    if (!_board.isValid()) {
+        _result = SolverResult::InvalidBoard;
+    } else {
+        _result = searchSolution(_board) ? SolverResult::NoError
+                                         : SolverResult::HasNoSolution;
+    }
+    return _result;
+}
+
+SolverResult SolveSession::setValueAt(uint8_t line, uint8_t column,
+                                      uint8_t value) {
+    const uint8_t oldValue = _board.valueAt(line, column);
+    if (_result == SolverResult::InvalidBoard ||
+        _board.setValueAt(line, column, value) != SetValueResult::NoError) {
+        return SolverResult::InvalidBoard;
+    }
+
+    if (_result == SolverResult::NoError) {
+        if (value == 0 || _solution.valueAt(line, column) == value) {
+            // The last solution is still a solution of the board.
+            return _result;
+        }
+        if (repairSolution(
+                static_cast<uint8_t>(line * Board::NUM_COLS + column),
+                value)) {
+            return _result;
+        }
+    } else if (oldValue == 0) {
+        // A value at a blank position only adds a constraint to a board
+        // without solution.
+        return _result;
+    } else if (solutionAgrees()) {
+        // Typically an edit that led to no solution being undone.
+        _result = SolverResult::NoError;
+        return _result;
+    }
+    _result = searchSolution(_board) ? SolverResult::NoError
+                                     : SolverResult::HasNoSolution;
+    return _result;
+}
+
+bool SolveSession::searchSolution(const Board &board) {
+    uint8_t values[Board::NUM_POS];
+    _numSearches++;
+    if (_engine->count(board, 1, values, nullptr) == 0) {
+        return false;
+    }
+    _solution = Board::fromValues(values);
+    return true;
+}
+
+bool SolveSession::solutionAgrees() const noexcept {
+    if (!_solution.isComplete()) {
+        return false;
+    }
+    for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            const uint8_t value = _board.valueAt(lin, col);
+            if (value != 0 && value != _solution.valueAt(lin, col)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool SolveSession::repairSolution(uint8_t pos, uint8_t value) {
+    // The new value displaces the old one at the position; the positions
+    // holding either of them are the ones a local change of the solution
+    // swaps around. Everything else keeps the values of the last solution.
+    const uint8_t oldValue =
+        _solution.valueAt(pos / Board::NUM_COLS, pos % Board::NUM_COLS);
+    uint8_t values[Board::NUM_POS];
+    for (uint8_t other = 0; other < Board::NUM_POS; other++) {
+        const uint8_t lin = other / Board::NUM_COLS;
+        const uint8_t col = other % Board::NUM_COLS;
+        const uint8_t given = _board.valueAt(lin, col);
+        const uint8_t solved = _solution.valueAt(lin, col);
+        if (given != 0) {
+            values[other] = given;
+        } else {
+            values[other] =
+                solved != oldValue && solved != value ? solved : 0;
+        }
+    }
+    return searchSolution(Board::fromValues(values));
+}
@@ -0,0 +1,109 @@
+#ifndef SOLVE_SESSION_H
+#define SOLVE_SESSION_H
+
+#include <cstdint>
+#include <memory>
+
+#include "board.h"
+#include "solver.h"
+
+namespace sudoku {
+
+/**
+ * @brief Keeps track of whether a board being edited one position at a time
+ * is still solvable.
+ *
+ * The session keeps the board, with its incrementally updated unit masks,
+ * and the last solution found for it. An edit that agrees with that solution
+ * - or that clears a position - is validated without searching, and so is
+ * the undoing of an edit that left the board without solution. An edit that
+ * doesn't is first searched for locally: only the positions whose values
+ * must move for the new value to fit are searched again, the others keeping
+ * the values of the last solution. The whole board is searched only when the
+ * local search fails.
+ */
+class SolveSession {
+   public:
+    explicit SolveSession(const Board &board);
+
+    SolveSession(const SolveSession &) = delete;
+    SolveSession &operator=(const SolveSession &) = delete;
+
+    ~SolveSession();
+
+    /**
+     * @brief Starts tracking a new board, searching for a solution of it.
+     *
+     * @return SolverResult::NoError if the board is solvable,
+     * SolverResult::InvalidBoard if it is invalid or
+     * SolverResult::HasNoSolution otherwise.
+     */
+    SolverResult reset(const Board &board);
+
+    /**
+     * @brief Sets the value of a position of the board and checks whether the
+     * board is still solvable.
+     *
+     * @param line the line number (from 0 to Board::NUM_ROWS - 1).
+     * @param column the column number (from 0 to Board::NUM_COLS - 1).
+     * @param value the value to be set - 0 clears the position.
+     * @return SolverResult::NoError if the board is solvable after the edit,
+     * SolverResult::HasNoSolution if it isn't or SolverResult::InvalidBoard if
+     * the value is rejected by the board - which is left unchanged - or the
+     * board tracked is invalid.
+     */
+    SolverResult setValueAt(std::uint8_t line, std::uint8_t column,
+                            std::uint8_t value);
+
+    /**
+     * @brief Whether the board, as of the last edit, is solvable.
+     */
+    SolverResult result() const noexcept { return _result; }
+
+    const Board &board() const noexcept { return _board; }
+
+    /**
+     * @brief The last solution found for the board - meaningful only while
+     * result() is SolverResult::NoError.
+     */
+    const Board &solution() const noexcept { return _solution; }
+
+    /**
+     * @brief The number of searches run since the board was reset, local
+     * ones included.
+     */
+    unsigned numSearches() const noexcept { return _numSearches; }
+
+   private:
+    /**
+     * @brief Searches for a solution of a board, storing it as the solution
+     * of the session.
+     *
+     * @return whether a solution was found.
+     */
+    bool searchSolution(const Board &board);
+
+    /**
+     * @brief Whether the last solution found, kept while the board has no
+     * solution, is a solution of the board.
+     */
+    bool solutionAgrees() const noexcept;
+
+    /**
+     * @brief Searches for a solution that differs from the last one only at
+     * the positions affected by an edit.
+     *
+     * @return whether a solution was found.
+     */
+    bool repairSolution(std::uint8_t pos, std::uint8_t value);
+
+    Board _board;
+    Board _solution;
+    SolverResult _result{SolverResult::InvalidBoard};
+    unsigned _numSearches{0};
+    std::unique_ptr<SearchEngine> _engine;
+};
+
+}  // namespace sudoku
+
+#endif
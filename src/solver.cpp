@@ -1,28 +1,166 @@
 #include "solver.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <thread>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "board.h"
+#include "lockstep_propagator.h"
+#include "logical_solver.h"
+#include "parallel_search.h"
+#include "search_engine.h"
 
-using std::make_pair;
-using std::make_shared;
+using std::atomic;
+using std::lock_guard;
+using std::make_unique;
+using std::mutex;
 using std::pair;
-using std::set;
-using std::shared_ptr;
-using std::unordered_set;
+using std::size_t;
+using std::uint16_t;
+using std::uint64_t;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
 using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using sudoku::BatchStats;
 using sudoku::Board;
+using sudoku::Hint;
+using sudoku::LockstepPropagator;
+using sudoku::LogicalSolver;
+using sudoku::LogicalStep;
+using sudoku::ParallelSearch;
+using sudoku::SearchEngine;
 using sudoku::Solver;
+using sudoku::SolverEngine;
+using sudoku::SolverOptions;
 using sudoku::SolverResult;
+using sudoku::SolverStats;
 
 const uint8_t MAX_VALUE = 9;
 
-Solver::Solver() : _asyncSolvingCancelled(false), _asyncSolvingActive(false) {}
+// Minimum number of solutions to be searched for by asyncSolveForGood for the
+// search to be split among threads - fewer solutions are found faster than
+// the threads can be started.
+const unsigned PARALLEL_MIN_SOLUTIONS = 100;
+
+// Minimum number of puzzles for solveBatch to propagate them in lockstep
+// before searching.
+const size_t LOCKSTEP_MIN_PUZZLES = 64;
+
+namespace {
+
+/**
+ * The dead ends reported as unsolvables found by the progress of
+ * asyncSolveForGood.
+ */
+unsigned unsolvables(uint64_t numBacktracks) noexcept {
+    return static_cast<unsigned>(std::min<uint64_t>(
+        numBacktracks, std::numeric_limits<unsigned>::max()));
+}
+
+/**
+ * Measures the phases of a solving call into its statistics, when the caller
+ * asked for them - otherwise the clock is never read.
+ */
+class PhaseTimer {
+   public:
+    explicit PhaseTimer(SolverStats *stats) noexcept : _stats(stats) {
+        if (_stats != nullptr) {
+            *_stats = SolverStats();
+            _phaseStart = steady_clock::now();
+        }
+    }
+
+    /**
+     * Ends the current phase, adding its duration to a given field of the
+     * statistics, and starts the next one.
+     */
+    void endPhase(double SolverStats::*phaseSeconds) noexcept {
+        if (_stats != nullptr) {
+            const auto now = steady_clock::now();
+            _stats->*phaseSeconds +=
+                duration<double>(now - _phaseStart).count();
+            _phaseStart = now;
+        }
+    }
+
+   private:
+    SolverStats *_stats;
+    steady_clock::time_point _phaseStart;
+};
+
+/**
+ * Points an engine at the statistics of a solving call for as long as the
+ * call lasts.
+ */
+class EngineStatsScope {
+   public:
+    EngineStatsScope(SearchEngine &engine, SolverStats *stats) noexcept
+        : _engine(engine) {
+        _engine.setStats(stats);
+    }
+
+    EngineStatsScope(const EngineStatsScope &) = delete;
+    EngineStatsScope &operator=(const EngineStatsScope &) = delete;
+
+    ~EngineStatsScope() { _engine.setStats(nullptr); }
+
+   private:
+    SearchEngine &_engine;
+};
+
+/**
+ * The engine a synchronous call searches with: the Solver's preallocated
+ * instance if no other call is using it, otherwise an engine created for the
+ * call - so concurrent calls never share an engine.
+ */
+class EngineLease {
+   public:
+    EngineLease(mutex &enginesMutex, SearchEngine &instance,
+                SolverEngine engine)
+        : _lock(enginesMutex, std::try_to_lock) {
+        if (_lock.owns_lock()) {
+            _engine = &instance;
+        } else {
+            _createdEngine = createEngine(engine);
+            _engine = _createdEngine.get();
+        }
+    }
+
+    SearchEngine &engine() const noexcept { return *_engine; }
+
+    // Whether the engine was created for the call.
+    bool created() const noexcept { return _createdEngine != nullptr; }
+
+   private:
+    unique_lock<mutex> _lock;
+    unique_ptr<SearchEngine> _createdEngine;
+    SearchEngine *_engine{nullptr};
+};
+
+}  // namespace
+
+Solver::Solver() : Solver(SolverOptions()) {}
+
+Solver::Solver(const SolverOptions &options)
+    : _options(options),
+      _asyncSolvingCancelled(false),
+      _asyncSolvingActive(false) {
+    for (const SolverEngine engine :
+         {SolverEngine::Bitboard, SolverEngine::DancingLinks,
+          SolverEngine::Backtracking}) {
+        _engines[static_cast<size_t>(engine)] = createEngine(engine);
+    }
+}
 
 Solver::~Solver() {
     if (_asyncSolvingActive) {
@@ -36,20 +174,30 @@ Solver::~Solver() {
 SolverResult Solver::asyncSolveForGood(const Board &board,
                                        const SolverProgressCallback &fnProgress,
                                        const SolverFinishedCallback &fnFinished,
-                                       unsigned maxSolutions) {
+                                       unsigned maxSolutions,
+                                       SolverStats *stats) {
     if (_asyncSolvingActive) {
         // Only one solving process can be active at once.
         return SolverResult::AsyncSolvingBusy;
     }
 
-    auto solutions = make_shared<vector<Board>>(vector<Board>());
+    // No engine is picked for a board that cannot be solved.
+    if (const auto solvable = checkBoard(board);
+        solvable != SolverResult::NoError) {
+        return solvable;
+    }
 
     _asyncSolvingActive = true;
     _asyncSolvingCancelled = false;
 
+    const SolverEngine engine =
+        selectEngine(_options.engine, board, SearchEngine::Enumeration);
+    const unsigned numThreads = _options.numThreads > 0
+                                    ? _options.numThreads
+                                    : ParallelSearch::defaultNumThreads();
     _solveForGoodWorker =
-        std::thread(&Solver::searchSolutions, this, board, fnProgress,
-                    fnFinished, solutions, maxSolutions, 0);
+        std::thread(&Solver::searchSolutions, this, board, engine, numThreads,
+                    fnProgress, fnFinished, maxSolutions, stats);
 
     // The worker will either be cancelled, reach the solutions or find that
     // there's no solution.
@@ -58,42 +206,294 @@ SolverResult Solver::asyncSolveForGood(const Board &board,
     return SolverResult::AsyncSolvingSubmitted;
 }
 
-SolverResult Solver::solve(const Board &puzzle, Board &solvedBoard) {
+SolverResult Solver::solve(const Board &puzzle, Board &solvedBoard,
+                           SolverStats *stats) {
+    // No engine is picked for a board that cannot be solved.
+    if (const auto solvable = checkBoard(puzzle);
+        solvable != SolverResult::NoError) {
+        if (stats != nullptr) {
+            *stats = SolverStats();
+        }
+        return solvable;
+    }
+    const SolverEngine engine =
+        selectEngine(_options.engine, puzzle, SearchEngine::FirstSolution);
+    const EngineLease lease(_enginesMutex, engineInstance(engine), engine);
+    const SolverResult result =
+        solveWith(lease.engine(), puzzle, solvedBoard, stats);
+    if (stats != nullptr && lease.created()) {
+        stats->enginesCreated++;
+    }
+    return result;
+}
+
+BatchStats Solver::solveBatch(const Board *puzzles, size_t numPuzzles,
+                              Board *solvedBoards, SolverResult *results,
+                              const BatchOptions &batchOptions) {
+    const auto start = steady_clock::now();
+    const size_t chunkSize = std::max(batchOptions.chunkSize, size_t{1});
+    const size_t numChunks = (numPuzzles + chunkSize - 1) / chunkSize;
+    unsigned numThreads = batchOptions.numThreads;
+    if (numThreads == 0) {
+        numThreads = _options.numThreads > 0
+                         ? _options.numThreads
+                         : ParallelSearch::defaultNumThreads();
+    }
+    // No more threads than chunks.
+    numThreads = static_cast<unsigned>(std::min(
+        static_cast<size_t>(numThreads), std::max(numChunks, size_t{1})));
+
+    // The engine for finding a first solution doesn't depend on the board,
+    // so it's picked before any puzzle is checked.
+    const SolverEngine engineKind = selectEngine(
+        _options.engine, Board(), SearchEngine::FirstSolution);
+    // Large batches are first propagated in lockstep, several puzzles at
+    // once; only the puzzles that need a search go through the engine.
+    const bool lockstep = _options.engine == SolverEngine::Auto &&
+                          numPuzzles >= LOCKSTEP_MIN_PUZZLES;
+    atomic<size_t> nextChunk(0);
+    atomic<size_t> numSolved(0);
+    const auto work = [&](SearchEngine &engine) {
+        LockstepPropagator propagator;
+        const size_t numLanes = LockstepPropagator::NUM_LANES;
+        Board group[numLanes];
+        size_t groupIndexes[numLanes];
+        size_t groupSize = 0;
+        // Propagates the puzzles gathered so far and searches the ones that
+        // propagation leaves unsolved, from the values it fixed.
+        const auto flushGroup = [&] {
+            LockstepPropagator::Outcome outcomes[numLanes];
+            Board propagated[numLanes];
+            propagator.propagate(group, groupSize, propagated, outcomes);
+            for (size_t lane = 0; lane < groupSize; lane++) {
+                const size_t i = groupIndexes[lane];
+                switch (outcomes[lane]) {
+                    case LockstepPropagator::Outcome::Solved:
+                        solvedBoards[i] = propagated[lane];
+                        results[i] = SolverResult::NoError;
+                        break;
+                    case LockstepPropagator::Outcome::NoSolution:
+                        results[i] = SolverResult::HasNoSolution;
+                        break;
+                    default:
+                        results[i] = solveWith(engine, propagated[lane],
+                                               solvedBoards[i]);
+                }
+            }
+            groupSize = 0;
+        };
+
+        size_t chunkSolved = 0;
+        for (size_t chunk = nextChunk++; chunk < numChunks;
+             chunk = nextChunk++) {
+            const size_t begin = chunk * chunkSize;
+            const size_t end = std::min(begin + chunkSize, numPuzzles);
+            for (size_t i = begin; i < end; i++) {
+                results[i] = checkBoard(puzzles[i]);
+                if (results[i] != SolverResult::NoError) {
+                    continue;
+                }
+                if (!lockstep) {
+                    results[i] = solveWith(engine, puzzles[i], solvedBoards[i]);
+                    continue;
+                }
+                group[groupSize] = puzzles[i];
+                groupIndexes[groupSize++] = i;
+                if (groupSize == numLanes) {
+                    flushGroup();
+                }
+            }
+            if (groupSize > 0) {
+                flushGroup();
+            }
+            for (size_t i = begin; i < end; i++) {
+                if (results[i] == SolverResult::NoError) {
+                    chunkSolved++;
+                }
+            }
+        }
+        numSolved += chunkSolved;
+    };
+
+    // The calling thread takes part with the solver's own engine, unless
+    // another call is using it; each of the other threads creates the engine
+    // it reuses for all its puzzles.
+    vector<thread> threads;
+    threads.reserve(numThreads - 1);
+    for (unsigned worker = 1; worker < numThreads; worker++) {
+        threads.emplace_back(
+            [&work, engineKind] { work(*createEngine(engineKind)); });
+    }
+    {
+        const EngineLease lease(_enginesMutex, engineInstance(engineKind),
+                                engineKind);
+        work(lease.engine());
+    }
+    for (auto &workerThread : threads) {
+        workerThread.join();
+    }
+
+    BatchStats stats;
+    stats.numPuzzles = numPuzzles;
+    stats.numSolved = numSolved;
+    stats.numThreads = numThreads;
+    stats.elapsedSeconds =
+        duration<double>(steady_clock::now() - start).count();
+    if (stats.elapsedSeconds > 0.0) {
+        stats.puzzlesPerSecond =
+            static_cast<double>(numPuzzles) / stats.elapsedSeconds;
+    }
+    return stats;
+}
+
+SolverResult Solver::solveWith(SearchEngine &engine, const Board &puzzle,
+                               Board &solvedBoard, SolverStats *stats) {
+    PhaseTimer timer(stats);
     auto solvable = checkBoard(puzzle);
+    timer.endPhase(&SolverStats::setupSeconds);
     if (solvable != SolverResult::NoError) {
         // Board is not solvable.
         return solvable;
     }
-    SolverResult result = SolverResult::NoError;
-    auto solutions = make_shared<vector<Board>>(vector<Board>());
-    searchSolutions(
-        puzzle, nullptr,
-        [&result](SolverResult solverResult, const vector<Board> &) {
-            result = solverResult;
-            // Ignore the vector of solutions passed as an argument to the
-            // callback. The vector of solutions will be pointed by the
-            // shared_ptr passed as the next argument to searchSolutions. The
-            // callback argument is used when searchSolutions is called
-            // asynchronously in a worker thread and the callback is the only
-            // way to communicate the results before finishing the worker
-            // thread.
+    const EngineStatsScope statsScope(engine, stats);
+    const unsigned numSolutions = engine.search(
+        puzzle,
+        [&solvedBoard](const Board &solution) {
+            solvedBoard = solution;
+            // The first solution is enough.
+            return false;
         },
-        solutions, 1, 0);
-    if (!solutions->empty()) {
-        solvedBoard = (*solutions)[0];
+        nullptr);
+    timer.endPhase(&SolverStats::searchSeconds);
+    return numSolutions > 0 ? SolverResult::NoError
+                            : SolverResult::HasNoSolution;
+}
+
+bool Solver::hasUniqueSolution(const Board &board, Board *solution) {
+    if (!board.isValid()) {
+        return false;
     }
-    return result;
+    uint8_t values[Board::NUM_POS];
+    const SolverEngine engine =
+        selectEngine(_options.engine, board, SearchEngine::Counting);
+    const EngineLease lease(_enginesMutex, engineInstance(engine), engine);
+    // A second solution is enough to tell the first one is not unique.
+    if (lease.engine().count(board, 2, values, nullptr) != 1) {
+        return false;
+    }
+    if (solution != nullptr) {
+        *solution = Board::fromValues(values);
+    }
+    return true;
+}
+
+uint64_t Solver::countSolutions(const Board &board, uint64_t limit,
+                                bool parallel) {
+    if (limit == 0 || !board.isValid()) {
+        return 0;
+    }
+    const SolverEngine engine =
+        selectEngine(_options.engine, board, SearchEngine::Counting);
+    const unsigned numThreads = _options.numThreads > 0
+                                    ? _options.numThreads
+                                    : ParallelSearch::defaultNumThreads();
+    if (parallel && numThreads > 1) {
+        const atomic<bool> cancelled(false);
+        return ParallelSearch(engine, numThreads)
+            .count(board, limit, cancelled);
+    }
+    const EngineLease lease(_enginesMutex, engineInstance(engine), engine);
+    return lease.engine().count(board, limit, nullptr, nullptr);
+}
+
+Hint Solver::nextHint(const Board &board) {
+    Hint hint;
+    if (!board.isValid()) {
+        return hint;
+    }
+    const lock_guard<mutex> lock(_hintMutex);
+    if (_hintSolver == nullptr) {
+        _hintSolver = make_unique<LogicalSolver>();
+        _hintSolver->load(board);
+    } else if (!updateHintGrid(board)) {
+        _hintSolver->load(board);
+    }
+
+    // A value deduced by an earlier hint and not placed on the board yet is
+    // still the cheapest deduction.
+    const vector<LogicalStep> &steps = _hintSolver->steps();
+    size_t firstStep = 0;
+    while (firstStep < steps.size() &&
+           (!steps[firstStep].placement ||
+            board.valueAt(steps[firstStep].pos / Board::NUM_COLS,
+                          steps[firstStep].pos % Board::NUM_COLS) != 0)) {
+        firstStep++;
+    }
+    if (firstStep == steps.size() && _hintSolver->step() == 0) {
+        return hint;
+    }
+    if (_hintSolver->contradiction()) {
+        // The deductions lead to a contradiction - the board has no solution.
+        return hint;
+    }
+
+    const LogicalStep &step = steps[firstStep];
+    hint.found = true;
+    hint.technique = step.technique;
+    hint.placement = step.placement;
+    hint.line = step.pos / Board::NUM_COLS;
+    hint.column = step.pos % Board::NUM_COLS;
+    hint.values = step.values;
+    hint.numPositions = 1;
+    // The steps of an application run up to the first step of the next one.
+    for (size_t next = firstStep + 1;
+         next < steps.size() && !steps[next].first; next++) {
+        hint.numPositions++;
+    }
+    return hint;
+}
+
+bool Solver::updateHintGrid(const Board &board) {
+    const Board reached = _hintSolver->board();
+    // Positions whose values were deduced - the board may not have them yet.
+    bool deduced[Board::NUM_POS]{};
+    for (const LogicalStep &step : _hintSolver->steps()) {
+        if (step.placement) {
+            deduced[step.pos] = true;
+        }
+    }
+    for (uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+        const uint8_t lin = pos / Board::NUM_COLS;
+        const uint8_t col = pos % Board::NUM_COLS;
+        const uint8_t value = board.valueAt(lin, col);
+        const uint8_t reachedValue = reached.valueAt(lin, col);
+        if (value == reachedValue || (value == 0 && deduced[pos])) {
+            continue;
+        }
+        // A value cleared or changed, or added where it can't be.
+        if (value == 0 || reachedValue != 0 ||
+            !_hintSolver->setValue(lin, col, value)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 SolverResult Solver::solveWithCandidates(const Board &board,
                                          const std::vector<uint8_t> &candidates,
-                                         Board &solvedBoard) {
+                                         Board &solvedBoard,
+                                         SolverStats *stats) {
+    PhaseTimer timer(stats);
     // Checks the vector of candidate values - it must have the integers from 1
     // to 9 without repetition.
-    auto [min, max] = std::minmax_element(candidates.begin(), candidates.end());
-    if (unordered_set<uint8_t> nonRep(candidates.begin(), candidates.end());
-        *min != 1 || *max != MAX_VALUE ||
-        nonRep.size() != MAX_VALUE) {
+    uint16_t valuesSeen = 0;
+    for (const uint8_t value : candidates) {
+        if (value >= 1 && value <= MAX_VALUE) {
+            valuesSeen |= static_cast<uint16_t>(1U << (value - 1U));
+        }
+    }
+    if (candidates.size() != MAX_VALUE ||
+        valuesSeen != (1U << MAX_VALUE) - 1U) {
         return SolverResult::InvalidatesCandidatesVector;
     }
 
@@ -102,173 +502,96 @@ SolverResult Solver::solveWithCandidates(const Board &board,
         return solvable;
     }
 
-    // Gather empty cells.
-    vector<pair<uint8_t, uint8_t>> emptyCells;
-
-    for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
-        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
-            if (board.valueAt(lin, col) == 0) {
-                emptyCells.emplace_back(lin, col);
-            }
-        }
-    }
-
-    solvedBoard = board;  // board is the starting point for solvedBoard.
-    size_t currCellPos = 0;
-    bool boardUnsolvable = false;
-    while (currCellPos < emptyCells.size() && !boardUnsolvable) {
-        auto currCell = emptyCells[currCellPos];
-        auto currCellValue =
-            solvedBoard.valueAt(currCell.first, currCell.second);
-        uint8_t candidatesIdx = 0;
-        if (currCellValue != 0) {
-            // We're backtracking - must start with the next candidate value.
-            candidatesIdx = static_cast<uint8_t>(
-                distance(
-                    candidates.begin(),
-                    find(candidates.begin(), candidates.end(), currCellValue)) +
-                1);
-        }
-
-        bool currCellSolved = false;
-        while (!currCellSolved && candidatesIdx < MAX_VALUE) {
-            auto result = solvedBoard.setValueAt(
-                currCell.first, currCell.second, candidates[candidatesIdx]);
-            if (result == SetValueResult::NoError) {
-                currCellSolved = true;
-            } else {
-                // Try the next value in the cell.
-                candidatesIdx++;
-            }
-        }
-        if (currCellSolved) {
-            currCellPos++;
-        } else {
-            // currCellVal >= 9 - have to roll back to the previous cell, if
-            // possible.
-            if (currCellPos > 0) {
-                // Resets the current cell before rolling back.
-                solvedBoard.setValueAt(currCell.first, currCell.second, 0);
-                currCellPos--;
-            } else {
-                boardUnsolvable = true;
-            }
-        }
+    const auto engine = createEngine(selectEngine(
+        SolverEngine::Auto, board,
+        SearchEngine::FirstSolution | SearchEngine::CandidateOrder));
+    engine->setCandidateOrder(candidates.data());
+    engine->setStats(stats);
+    if (stats != nullptr) {
+        stats->enginesCreated++;
     }
-    if (boardUnsolvable) {
-        return SolverResult::HasNoSolution;
-    }
-    return SolverResult::NoError;
+    timer.endPhase(&SolverStats::setupSeconds);
+    const unsigned numSolutions = engine->search(
+        board,
+        [&solvedBoard](const Board &solution) {
+            solvedBoard = solution;
+            return false;
+        },
+        nullptr);
+    timer.endPhase(&SolverStats::searchSeconds);
+    return numSolutions > 0 ? SolverResult::NoError
+                            : SolverResult::HasNoSolution;
 }
 
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "misc-no-recursion"
-
-void Solver::searchSolutions(const Board &board,
+void Solver::searchSolutions(const Board &board, SolverEngine engine,
+                             unsigned numThreads,
                              const SolverProgressCallback &fnProgress,
                              const SolverFinishedCallback &fnFinished,
-                             const shared_ptr<vector<Board>> &solutions,
-                             unsigned maxSolutions, unsigned level) {
-    static unsigned unsolvablesFound = 0;
-    static double progressPercent = 0.0;
-    auto blanks = board.getBlankPositions();
-    if (blanks.empty()) {
-        // The board is a solution, no need to go on with the search.
-        solutions->push_back(board);
-        return;
-    }
-    vector<set<uint8_t>> possibleValues;
-    possibleValues.reserve(blanks.size());
-    for (auto &blank : blanks) {
-        possibleValues.emplace_back(
-            board.getPossibleValues(blank.first, blank.second));
-    }
-    if (_asyncSolvingCancelled) {
-        if (level == 0) {
-            _asyncSolvingActive = false;
-            _asyncSolvingCancelled = false;
-            if (fnFinished != nullptr) {
-                vector<Board> boards(solutions->cbegin(), solutions->cend());
-                fnFinished(SolverResult::AsyncSolvingCancelled, boards);
-            }
+                             unsigned maxSolutions, SolverStats *stats) {
+    // Counted even if the caller didn't ask for them, as the progress reports
+    // the dead ends found so far.
+    SolverStats searchStats;
+    PhaseTimer timer(&searchStats);
+    vector<Board> solutions;
+    const auto onSolution = [&solutions, &searchStats,
+                             maxSolutions](const Board &solution) {
+        if (solutions.size() == solutions.capacity()) {
+            searchStats.solutionGrowths++;
         }
-        return;
-    }
-    if (solutions->size() >= maxSolutions) {
-        // Found the maximum number of solutions already. No need to go
-        // on.
-        if (level == 0) {
-            _asyncSolvingActive = false;
-            _asyncSolvingCancelled = false;
-
-            if (fnFinished != nullptr) {
-                vector<Board> boards(solutions->cbegin(), solutions->cend());
-                fnFinished(SolverResult::NoError, boards);
-            }
+        solutions.push_back(solution);
+        return solutions.size() < maxSolutions;
+    };
+    const auto onProgress = [this, &fnProgress, &solutions,
+                             &searchStats](double progressPercent) {
+        if (fnProgress != nullptr) {
+            fnProgress(progressPercent, unsolvables(searchStats.backtracks),
+                       static_cast<unsigned>(solutions.size()));
         }
-        return;
-    }
-    // Selects the position with the least possible values to be the one that
-    // will be filled next.
-    size_t minSize = Board::MAX_VAL + 1;
-    int possValIdx = -1;
-    for (size_t j = 0; j < possibleValues.size(); j++) {
-        if (!possibleValues[j].empty() && possibleValues[j].size() < minSize) {
-            possValIdx = static_cast<int>(j);
-            minSize = possibleValues[j].size();
-        } else if (possibleValues[j].empty()) {
-            // There's at least one blank position for which there's no option
-            // value
-            // - the board is not solvable.
-            if (level == 0) {
-                _asyncSolvingActive = false;
-                _asyncSolvingCancelled = false;
-                if (fnFinished != nullptr) {
-                    fnFinished(SolverResult::HasNoSolution, vector<Board>());
+        return !_asyncSolvingCancelled;
+    };
+    if (maxSolutions >= PARALLEL_MIN_SOLUTIONS && numThreads > 1) {
+        ParallelSearch parallelSearch(engine, numThreads);
+        timer.endPhase(&SolverStats::setupSeconds);
+        solutions = parallelSearch.search(
+            board, maxSolutions, _asyncSolvingCancelled,
+            [&fnProgress](double progressPercent, unsigned numSolutions,
+                          uint64_t numBacktracks) {
+                if (fnProgress != nullptr) {
+                    fnProgress(progressPercent, unsolvables(numBacktracks),
+                               numSolutions);
                 }
-            }
-            return;
-        }
+            });
+        mergeStats(searchStats, parallelSearch.stats());
+    } else if (maxSolutions > 0) {
+        // The worker has an engine of its own, so that solve can be used
+        // while it runs.
+        const auto workerEngine = createEngine(engine);
+        searchStats.enginesCreated++;
+        workerEngine->setStats(&searchStats);
+        timer.endPhase(&SolverStats::setupSeconds);
+        workerEngine->search(board, onSolution, onProgress);
     }
-    vector<uint8_t> possVals(possibleValues[possValIdx].cbegin(),
-                             possibleValues[possValIdx].cend());
-    for (size_t i = 0; i < possVals.size(); i++) {
-        Board nextBoard(board);
-        nextBoard.setValueAt(blanks[possValIdx].first,
-                             blanks[possValIdx].second, possVals[i]);
-        if (level == 0) {
-            // When at first level (searching with the original board
-            // puzzle), update progress (a rough approximation based on the
-            // progress of depth first searches for each possible value at the
-            // initial search node).
-            progressPercent = ((static_cast<double>(i) + 1.0) /
-                               static_cast<double>(possVals.size())) *
-                              100.0;
-        }
-        if (fnProgress != nullptr) {
-            fnProgress(progressPercent, unsolvablesFound,
-                       static_cast<unsigned>(solutions->size()));
-        }
-        searchSolutions(nextBoard, fnProgress, fnFinished, solutions,
-                        maxSolutions, level + 1);
-    }
-    if (level == 0) {
-        // Reaching this point at level 0 means we are done.
-        _asyncSolvingActive = false;
-        _asyncSolvingCancelled = false;
-
-        if (fnFinished != nullptr) {
-            vector<Board> boards(solutions->cbegin(), solutions->cend());
-            if (solutions->empty()) {
-                fnFinished(SolverResult::HasNoSolution, boards);
-            } else {
-                fnFinished(SolverResult::NoError, boards);
-            }
-        }
+    timer.endPhase(&SolverStats::searchSeconds);
+
+    SolverResult result = SolverResult::NoError;
+    if (_asyncSolvingCancelled) {
+        result = SolverResult::AsyncSolvingCancelled;
+    } else if (solutions.empty() && maxSolutions > 0) {
+        result = SolverResult::HasNoSolution;
+    }
+    if (stats != nullptr) {
+        *stats = searchStats;
+    }
+    _asyncSolvingActive = false;
+    _asyncSolvingCancelled = false;
+    if (fnFinished != nullptr) {
+        fnFinished(result, solutions);
     }
 }
 
-#pragma clang diagnostic pop
+SearchEngine &Solver::engineInstance(SolverEngine engine) const noexcept {
+    return *_engines[static_cast<size_t>(engine)];
+}
 
 void Solver::cancelAsyncSolving() { _asyncSolvingCancelled = true; }
 
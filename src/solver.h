@@ -2,15 +2,26 @@
 #define SOLVER_H
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
 namespace sudoku {
 
-class Board;
+template <std::uint8_t BoxRows, std::uint8_t BoxCols>
+class BasicBoard;
+
+using Board = BasicBoard<3, 3>;
+
+class SearchEngine;
+
+class LogicalSolver;
+
+enum class Technique : std::uint8_t;
 
 enum class SolverResult : uint8_t {
     NoError,
@@ -24,7 +35,106 @@ enum class SolverResult : uint8_t {
     AsyncSolvingBusy
 };
 
-// Signature of callback to report progress of an async solving process.
+/**
+ * @brief The algorithms available for searching the solutions of a board.
+ */
+enum class SolverEngine : uint8_t {
+    // Picks the engine expected to be the fastest for each board.
+    Auto,
+    // Bit mask candidates with singles propagation - the fastest at finding a
+    // solution.
+    Bitboard,
+    // Dancing Links exact cover search - the fastest at enumerating the
+    // solutions of boards with few values.
+    DancingLinks,
+    // Line-major backtracking - the only engine that honors the candidates
+    // order of solveWithCandidates.
+    Backtracking
+};
+
+struct SolverOptions {
+    // The engine used by solve and asyncSolveForGood. An engine that cannot
+    // perform an operation is replaced by the Auto choice for it.
+    SolverEngine engine{SolverEngine::Auto};
+
+    // The number of threads asyncSolveForGood and parallel countSolutions
+    // split large searches among - 0 means one thread per core.
+    unsigned numThreads{0};
+};
+
+struct BatchOptions {
+    // The number of threads the batch is split among - 0 means the number
+    // of threads in the SolverOptions.
+    unsigned numThreads{0};
+
+    // The number of consecutive puzzles a thread takes at once.
+    std::size_t chunkSize{256};
+};
+
+// Whether the engines count the nodes, backtracks, depth and eliminations of
+// SolverStats - the counting compiles away in builds of the library with the
+// LIBSUDOKU_SOLVER_STATS option off.
+#if defined(SUDOKU_NO_SOLVER_STATS)
+constexpr bool SOLVER_STATS_ENABLED = false;
+#else
+constexpr bool SOLVER_STATS_ENABLED = true;
+#endif
+
+// Statistics of a single solving call - the timings are measured even when
+// the counting is compiled away.
+struct SolverStats {
+    // Values tried at the branching points of the search.
+    std::uint64_t nodes{0};
+    // Values tried that led to a dead end.
+    std::uint64_t backtracks{0};
+    // Maximum number of branching points on a search path.
+    std::uint32_t maxDepth{0};
+    // Candidates taken off by propagation - 0 for engines without it.
+    std::uint64_t eliminations{0};
+    // Time spent checking the board and setting up the search.
+    double setupSeconds{0.0};
+    // Time spent searching.
+    double searchSeconds{0.0};
+    // Search engines created for the call - 0 when a solve or a count is
+    // served by the Solver's preallocated engine.
+    std::uint32_t enginesCreated{0};
+    // Times the storage of the solutions found was grown to hold more of
+    // them - each one a heap allocation.
+    std::uint32_t solutionGrowths{0};
+};
+
+// Aggregate statistics of a solveBatch call.
+struct BatchStats {
+    std::size_t numPuzzles{0};
+    // Puzzles whose result is SolverResult::NoError.
+    std::size_t numSolved{0};
+    // Number of threads actually used.
+    unsigned numThreads{0};
+    double elapsedSeconds{0.0};
+    double puzzlesPerSecond{0.0};
+};
+
+// A deduction suggested by Solver::nextHint.
+struct Hint {
+    // Whether a deduction applies - false for boards that are invalid,
+    // solved, contradictory or beyond the techniques of LogicalSolver.
+    bool found{false};
+    Technique technique{};
+    // Whether the hint places a value - otherwise it eliminates candidates.
+    bool placement{false};
+    std::uint8_t line{0};
+    std::uint8_t column{0};
+    // The value placed, or the bit mask of the candidates eliminated - bit 0
+    // for value 1.
+    std::uint16_t values{0};
+    // The number of positions the deduction places a value at or eliminates
+    // candidates from - the one described above is the first of them.
+    std::uint8_t numPositions{0};
+};
+
+// Signature of callback to report progress of an async solving process. The
+// unsolvables found are the dead ends of the search so far, as counted by
+// SolverStats::backtracks - always 0 when the counting is compiled away.
 using SolverProgressCallback = std::function<void(
     double /* progressPercentage */, unsigned /* unsolvablesFound */,
     unsigned /* numSolutions */)>;
@@ -33,10 +143,22 @@ using SolverProgressCallback = std::function<void(
 using SolverFinishedCallback = std::function<void(
     SolverResult /* result */, const std::vector<Board> & /* solvedBoards */)>;
 
+/**
+ * @brief Solves Sudoku puzzles, checks their solutions and counts them.
+ *
+ * The synchronous operations - solve, solveBatch, hasUniqueSolution and
+ * countSolutions - can be called on the same Solver from several threads at
+ * once. The engines preallocated by the Solver serve one call at a time; a
+ * call that finds them in use searches with an engine created for it. Calls
+ * to nextHint share one candidate grid, so they run one at a time. The
+ * options must not be changed while other calls are going on.
+ */
 class Solver {
    public:
     Solver();
 
+    explicit Solver(const SolverOptions &options);
+
     Solver(const Solver &) = delete;
     Solver(Solver &&) = delete;
     Solver &operator=(const Solver &) = delete;
@@ -44,6 +166,16 @@ class Solver {
 
     ~Solver();
 
+    const SolverOptions &options() const noexcept { return _options; }
+
+    /**
+     * Sets the options for the next solving requests - an async solving
+     * process already going on is not affected.
+     */
+    void setOptions(const SolverOptions &options) noexcept {
+        _options = options;
+    }
+
     /**
      * Solves a Sudoku puzzle in a given solverResult, if it is solvable.
      *
@@ -52,9 +184,40 @@ class Solver {
      * @param solvedBoard the board with the solution found for the
      * puzzle.
      *
+     * @param stats if not null, receives the statistics of the call.
+     *
      * @return a SolverResult indicating the result of the operation.
      */
-    SolverResult solve(const Board &puzzle, Board &solvedBoard);
+    SolverResult solve(const Board &puzzle, Board &solvedBoard,
+                       SolverStats *stats = nullptr);
+
+    /**
+     * Solves a batch of Sudoku puzzles, each one as solve would.
+     *
+     * The batch is split into chunks of consecutive puzzles taken by a set of
+     * threads, each one with its own engine; the solution and the result of
+     * each puzzle are stored at its index, whatever thread solves it. With
+     * SolverEngine::Auto, large batches are first propagated several puzzles
+     * at a time with vector instructions, leaving the engine only the
+     * puzzles that need a search.
+     *
+     * @param puzzles the boards with the puzzles to be solved.
+     *
+     * @param numPuzzles the number of puzzles in the batch.
+     *
+     * @param solvedBoards receives the solution of each puzzle - left
+     * untouched for the puzzles without one. Must hold numPuzzles boards.
+     *
+     * @param results receives the result of each puzzle. Must hold numPuzzles
+     * results.
+     *
+     * @param batchOptions how the batch is split among threads.
+     *
+     * @return the aggregate statistics of the batch.
+     */
+    BatchStats solveBatch(const Board *puzzles, std::size_t numPuzzles,
+                          Board *solvedBoards, SolverResult *results,
+                          const BatchOptions &batchOptions = BatchOptions());
 
     /**
      * Solves a Sudoku puzzle in a given board, if it is solvable, using a
@@ -73,15 +236,66 @@ class Solver {
      *
      * @param solvedBoard the board with the solution found for the puzzle.
      *
+     * @param stats if not null, receives the statistics of the call.
+     *
      * @return a SolverResult indicating the result of the operation.
      */
     static SolverResult solveWithCandidates(const Board &board,
                               const std::vector<uint8_t> &candidates,
-                              Board &solvedBoard);
+                              Board &solvedBoard,
+                              SolverStats *stats = nullptr);
+
+    /**
+     * Checks whether a Sudoku puzzle has exactly one solution. The search
+     * stops as soon as a second solution is found.
+     *
+     * @param board the board with the puzzle to be checked.
+     *
+     * @param solution if not null, receives the solution of the puzzle when
+     * it is unique - left untouched otherwise.
+     *
+     * @return true if the board is valid and has exactly one solution.
+     */
+    bool hasUniqueSolution(const Board &board, Board *solution = nullptr);
+
+    /**
+     * Counts the solutions of a Sudoku puzzle, up to a limit, without keeping
+     * them.
+     *
+     * @param board the board with the puzzle whose solutions will be counted.
+     *
+     * @param limit the count at which the search stops.
+     *
+     * @param parallel whether the search is split among the number of threads
+     * in the options - pays off for counts in the millions.
+     *
+     * @return the number of solutions of the puzzle, at most limit - 0 for an
+     * invalid board.
+     */
+    std::uint64_t countSolutions(const Board &board, std::uint64_t limit,
+                                 bool parallel = false);
+
+    /**
+     * Finds the cheapest logical deduction that applies to a board, trying
+     * the techniques of LogicalSolver from the cheapest one.
+     *
+     * The candidate grid of the last board hinted is kept between calls, with
+     * the deductions made on it. When the board is the last one with values
+     * added - a game going on - the values are placed on the grid instead of
+     * rebuilding it, and a value deduced earlier but not placed yet is hinted
+     * again without searching. Any other board rebuilds the grid.
+     *
+     * @param board the board to find a deduction for.
+     *
+     * @return the deduction found.
+     */
+    Hint nextHint(const Board &board);
 
     /**
      * Asynchronously finds the solutions for a Sudoku puzzle in a given
-     * board, if the board is solvable.
+     * board, if the board is solvable. The solutions reported are the same,
+     * in the same order, on every search of the board with the same options,
+     * unless it is cancelled.
      *
      * @param board the board with the puzzle to be solved.
      *
@@ -93,15 +307,21 @@ class Solver {
      *
      * @param maxSolutions the maximum number of solutions to find.
      *
+     * @param stats if not null, receives the statistics of the solving
+     * process before fnFinished is called - must outlive the process.
+     *
      * @return SolverResult::ASYNC_SOLVING_SUBMITTED if the asynchronous request
-     * for finding all solutions has been accepted or
+     * for finding all solutions has been accepted,
      * SolverResult::ASYNC_SOLVING_BUSY if there's already an active solving
-     * process and the request got rejected.
+     * process and the request got rejected or the reason why the board cannot
+     * be solved - in which case no solving process is started and fnFinished
+     * is not called.
      */
     SolverResult asyncSolveForGood(const Board &board,
                                    const SolverProgressCallback &fnProgress,
                                    const SolverFinishedCallback &fnFinished,
-                                   unsigned maxSolutions);
+                                   unsigned maxSolutions,
+                                   SolverStats *stats = nullptr);
 
     /**
      * Cancels an async solving processing if there's one going on.
@@ -126,34 +346,68 @@ class Solver {
      */
     static SolverResult checkBoard(const Board &board);
 
-    // Internal method that does the real work for finding the solutions
-    // to a given board. "level"
     /**
-     * Recursively searches for all the possible solutions for a board, up to
-     * the current value of _maxSolutions.
+     * Solves a puzzle with a given engine - the body of solve.
+     */
+    static SolverResult solveWith(SearchEngine &engine, const Board &puzzle,
+                                  Board &solvedBoard,
+                                  SolverStats *stats = nullptr);
+
+    /**
+     * Searches for the solutions of a board, up to maxSolutions, with a
+     * given engine and reports the result through fnFinished. Runs in
+     * the worker thread spawned by asyncSolveForGood.
      *
      * @param board a board whose solutions should be found.
      *
+     * @param engine the engine to search with - never SolverEngine::Auto.
+     *
+     * @param numThreads the number of threads to split the search among when
+     * searching for many solutions.
+     *
      * @param fnProgress the callback for reporting progress of the solving
      * process.
      *
      * @param fnFinished the callback for reporting result of the solving
      * process.
      *
-     * @param solutions the solutions found so far by searchSolutions.
-     *
      * @param maxSolutions the maximum number of solutions to find.
      *
-     * @param level the search level, 0 being the original board, 1 the level
-     * where 1 empty position from the original board has been resolved and the
-     * search is for possible solutions with a given first level set, and so on.
-     *
+     * @param stats if not null, receives the statistics of the search.
      */
-    void searchSolutions(const Board &board,
+    void searchSolutions(const Board &board, SolverEngine engine,
+                         unsigned numThreads,
                          const SolverProgressCallback &fnProgress,
                          const SolverFinishedCallback &fnFinished,
-                         const std::shared_ptr<std::vector<Board>> &solutions,
-                         unsigned maxSolutions, unsigned level);
+                         unsigned maxSolutions, SolverStats *stats);
+
+    /**
+     * Brings the candidate grid of nextHint up to date with a board, placing
+     * the values the board added to it.
+     *
+     * @return false if the board is not the last one hinted with values
+     * added - the grid must be rebuilt.
+     */
+    bool updateHintGrid(const Board &board);
+
+    /**
+     * The preallocated instance of a given engine - so synchronous solving
+     * makes no allocations. Only searched with while holding _enginesMutex.
+     */
+    SearchEngine &engineInstance(SolverEngine engine) const noexcept;
+
+    SolverOptions _options;
+
+    // One instance of each engine, indexed by SolverEngine; Auto has none.
+    static const std::size_t NUM_ENGINES = 4;
+    std::unique_ptr<SearchEngine> _engines[NUM_ENGINES];
+    // Held by the synchronous call using the engines.
+    std::mutex _enginesMutex;
+
+    // The candidate grid of nextHint - created by its first call.
+    std::unique_ptr<LogicalSolver> _hintSolver;
+    // Held by the nextHint call using the grid.
+    std::mutex _hintMutex;
 
     std::atomic<bool> _asyncSolvingCancelled;
     std::atomic<bool> _asyncSolvingActive;
@@ -1,5 +1,13 @@
 #define CATCH_CONFIG_MAIN
 
+#include <array>
+#include <set>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "../board.h"
 #include "catch.hpp"
 
@@ -227,3 +235,254 @@ TEST_CASE("Possible values exclude any value in same line, column or section") {
     REQUIRE(possibleValues.count(6) == 0);
     REQUIRE(possibleValues.count(4) == 0);
 }
+
+TEST_CASE("Change that keeps the board invalid is rejected") {
+    Board board(invalid_board_section);
+    // Clearing only one of the repeated values leaves the other repetition.
+    auto result = board.setValueAt(1, 1, 0);
+    REQUIRE((result == SetValueResult::ValueInvalidatesBoard));
+    REQUIRE(board == invalid_board_section);
+}
+
+TEST_CASE("Clearing an out-of-range value makes the board valid again") {
+    Board board(invalid_board_value_range);
+    REQUIRE(!board.isValid());
+    auto result = board.setValueAt(0, 1, 0);
+    REQUIRE((result == SetValueResult::NoError));
+    REQUIRE(board.isValid());
+    REQUIRE(board.getPossibleValues(0, 1) == std::set<uint8_t>{9});
+}
+
+TEST_CASE("Possible values are updated after clear") {
+    Board board(solved_board);
+    board.clear();
+    REQUIRE(board.isEmpty());
+    REQUIRE(board.isValid());
+    REQUIRE(board.getPossibleValues(4, 4).size() == 9);
+}
+
+TEST_CASE("Candidates match the possible values of a position") {
+    Board board;
+    board.setValueAt(0, 0, 1);
+    board.setValueAt(1, 1, 6);
+    board.setValueAt(8, 1, 4);
+    const CandidateSet candidates = board.getCandidates(0, 1);
+    REQUIRE(candidates.size() == 6);
+    REQUIRE(!candidates.contains(1));
+    REQUIRE(!candidates.contains(4));
+    REQUIRE(!candidates.contains(6));
+    const std::set<uint8_t> fromCandidates(candidates.begin(),
+                                           candidates.end());
+    REQUIRE(fromCandidates == board.getPossibleValues(0, 1));
+    REQUIRE(board.getCandidates(0, 0).empty());
+}
+
+TEST_CASE("CandidateSet supports set algebra and ordered iteration") {
+    CandidateSet odds;
+    for (uint8_t val = 1; val <= 9; val += 2) {
+        odds.insert(val);
+    }
+    const CandidateSet evens = CandidateSet::all() - odds;
+    REQUIRE(odds.size() == 5);
+    REQUIRE(evens.size() == 4);
+    REQUIRE((odds & evens).empty());
+    REQUIRE((odds | evens) == CandidateSet::all());
+    REQUIRE(~odds == evens);
+    REQUIRE(evens.lowest() == 2);
+
+    std::vector<uint8_t> values(odds.begin(), odds.end());
+    REQUIRE(values == std::vector<uint8_t>{1, 3, 5, 7, 9});
+
+    CandidateSet remaining(evens);
+    REQUIRE(remaining.popLowest() == 2);
+    REQUIRE(remaining.popLowest() == 4);
+    REQUIRE(remaining.size() == 2);
+    remaining.erase(8);
+    REQUIRE(remaining.popLowest() == 6);
+    REQUIRE(remaining.empty());
+    REQUIRE(remaining.popLowest() == 0);
+}
+
+TEST_CASE("Rejected value leaves the board untouched") {
+    Board board(board_with_blanks);
+    // 9 is already in the line; 3 is already in the column.
+    REQUIRE((board.setValueAt(8, 1, 9) == SetValueResult::ValueInvalidatesBoard));
+    REQUIRE((board.setValueAt(8, 1, 3) == SetValueResult::ValueInvalidatesBoard));
+    REQUIRE(board == board_with_blanks);
+    REQUIRE(board.isValid());
+    REQUIRE(board.getPossibleValues(8, 1) == std::set<uint8_t>{5});
+    // Replacing a filled value with a conflicting one is rejected as well.
+    REQUIRE((board.setValueAt(0, 0, 9) == SetValueResult::ValueInvalidatesBoard));
+    REQUIRE(board.valueAt(0, 0) == 2);
+    REQUIRE((board.setValueAt(8, 1, 5) == SetValueResult::NoError));
+    REQUIRE(board.getInvalidPositions().empty());
+}
+
+TEST_CASE("Board hash is maintained incrementally") {
+    Board board(board_with_blanks);
+    const uint64_t initialHash = board.hash();
+    REQUIRE(initialHash != Board().hash());
+    board.setValueAt(0, 4, 4);
+    board.setValueAt(8, 1, 5);
+    // Same values as the solved board, reached through a different path.
+    REQUIRE(board == solved_board);
+    REQUIRE(board.hash() == solved_board.hash());
+    board.setValueAt(0, 4, 0);
+    board.setValueAt(8, 1, 0);
+    REQUIRE(board.hash() == initialHash);
+    board.clear();
+    REQUIRE(board.hash() == clear_board.hash());
+}
+
+TEST_CASE("Boards can be stored in unordered containers") {
+    std::unordered_set<Board> boards{solved_board, board_with_blanks,
+                                     Board(solved_board), clear_board};
+    REQUIRE(boards.size() == 3);
+    REQUIRE(boards.count(Board()) == 1);
+    REQUIRE(boards.count(invalid_board_section) == 0);
+}
+
+constexpr Board constexpr_board(std::array<uint8_t, Board::NUM_POS>{
+    // clang-format off
+    0, 0, 6, 0, 0, 8, 5, 0, 0,
+    0, 0, 0, 0, 7, 0, 6, 1, 3,
+    0, 0, 0, 0, 0, 0, 0, 0, 9,
+    0, 0, 0, 0, 9, 0, 0, 0, 1,
+    0, 0, 1, 0, 0, 0, 8, 0, 0,
+    4, 0, 0, 5, 3, 0, 0, 0, 0,
+    1, 0, 7, 0, 5, 3, 0, 0, 0,
+    0, 5, 0, 0, 6, 4, 0, 0, 0,
+    3, 0, 0, 1, 0, 0, 0, 6, 0,
+    // clang-format on
+});
+
+constexpr Board constexpr_invalid_board(std::array<uint8_t, Board::NUM_POS>{
+    // clang-format off
+    1, 0, 0, 0, 0, 0, 0, 0, 1, // 1 is repeated in the first line.
+    // clang-format on
+});
+
+static_assert(constexpr_board.isValid(), "Board must be valid");
+static_assert(!constexpr_board.isComplete(), "Board must not be complete");
+static_assert(constexpr_board.blankPositionCount() == 56,
+              "Board must have 56 blanks");
+static_assert(constexpr_board.valueAt(0, 2) == 6, "Value must be 6");
+static_assert(!constexpr_invalid_board.isValid(), "Board must be invalid");
+static_assert(Board().isValid() && Board().blankPositionCount() == 81,
+              "Default board must be valid and blank");
+
+TEST_CASE("constexpr board behaves like a runtime board") {
+    std::vector<uint8_t> values;
+    for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            values.push_back(constexpr_board.valueAt(lin, col));
+        }
+    }
+    const Board runtime_board(values);
+    REQUIRE(constexpr_board == runtime_board);
+    REQUIRE(constexpr_board.hash() == runtime_board.hash());
+    REQUIRE(constexpr_board.getPossibleValues(0, 0) ==
+            runtime_board.getPossibleValues(0, 0));
+}
+
+static_assert(std::is_same<BasicBoard<4, 4>::MaskType, uint16_t>::value,
+              "16x16 boards must use 16-bit masks");
+static_assert(std::is_same<BasicBoard<5, 5>::MaskType, uint32_t>::value,
+              "25x25 boards must use 32-bit masks");
+static_assert(BasicBoard<5, 5>().blankPositionCount() == 625,
+              "Default 25x25 board must be blank");
+
+TEST_CASE("4x4 board follows the Sudoku rules") {
+    BasicBoard<2, 2> board(std::vector<uint8_t>{
+        // clang-format off
+        1, 2, 3, 4,
+        3, 4, 1, 2,
+        2, 1, 4, 3,
+        4, 3, 2, 0,
+        // clang-format on
+    });
+    REQUIRE(board.isValid());
+    REQUIRE(board.blankPositionCount() == 1);
+    REQUIRE(board.getPossibleValues(3, 3) == std::set<uint8_t>{1});
+    REQUIRE((board.setValueAt(3, 3, 5) == SetValueResult::InvalidValue));
+    REQUIRE((board.setValueAt(3, 3, 4) ==
+             SetValueResult::ValueInvalidatesBoard));
+    REQUIRE((board.setValueAt(3, 3, 1) == SetValueResult::NoError));
+    REQUIRE(board.isComplete());
+}
+
+TEST_CASE("6x6 board has sections of 2 lines by 3 columns") {
+    BasicBoard<2, 3> board;
+    REQUIRE((board.setValueAt(0, 0, 6) == SetValueResult::NoError));
+    // (1, 2) shares the section of (0, 0); (2, 0) does not.
+    REQUIRE(!board.getCandidates(1, 2).contains(6));
+    REQUIRE(board.getCandidates(2, 1).contains(6));
+    REQUIRE((board.setValueAt(1, 2, 6) ==
+             SetValueResult::ValueInvalidatesBoard));
+    REQUIRE((board.setValueAt(2, 1, 6) == SetValueResult::NoError));
+    REQUIRE(board.getPossibleValues(5, 5).size() == 6);
+}
+
+TEST_CASE("25x25 board detects repetitions of its largest value") {
+    BasicBoard<5, 5> board;
+    REQUIRE((board.setValueAt(24, 0, 25) == SetValueResult::NoError));
+    REQUIRE((board.setValueAt(20, 4, 25) ==
+             SetValueResult::ValueInvalidatesBoard));
+    REQUIRE(board.getCandidates(24, 24).size() == 24);
+    REQUIRE(board.getInvalidPositions().empty());
+    std::vector<uint8_t> values(BasicBoard<5, 5>::NUM_POS, 0);
+    values[0] = 25;
+    values[24] = 25;
+    values[624] = 26;
+    const BasicBoard<5, 5> invalid(values);
+    REQUIRE(!invalid.isValid());
+    REQUIRE(invalid.getInvalidPositions() ==
+            std::vector<std::pair<uint8_t, uint8_t>>{{0, 0}, {0, 24}, {24, 24}});
+}
+
+constexpr Board string_board = Board::fromString(
+    "..6..85.."
+    "....7.613"
+    "........9"
+    "....9...1"
+    "..1...8.."
+    "4..53...."
+    "1.7.53..."
+    ".5..64..."
+    "3..1...6.");
+
+static_assert(string_board.isValid() && string_board.valueAt(0, 2) == 6,
+              "Board read from a string must be valid");
+static_assert(!Board::fromString("1x").isValid(),
+              "Unknown characters must invalidate the board");
+
+TEST_CASE("Board read from a string equals the board read from values") {
+    REQUIRE(string_board == constexpr_board);
+    REQUIRE(Board::fromString("") == Board());
+
+    std::array<uint8_t, Board::NUM_POS> values{};
+    for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            values[lin * Board::NUM_COLS + col] = solved_board.valueAt(lin, col);
+        }
+    }
+    REQUIRE(Board::fromValues(values.data()) == solved_board);
+}
+
+TEST_CASE("Board written with toChars reads back unchanged") {
+    char text[Board::NUM_POS];
+    REQUIRE(board_with_blanks.toChars(text) == text + Board::NUM_POS);
+    REQUIRE(text[0] == '2');
+    REQUIRE(text[4] == '0');
+    REQUIRE(Board::fromString(std::string_view(text, Board::NUM_POS)) ==
+            board_with_blanks);
+
+    // Values above 9 are letters in larger boards.
+    BasicBoard<4, 4> large;
+    large.setValueAt(0, 1, 16);
+    char largeText[BasicBoard<4, 4>::NUM_POS];
+    large.toChars(largeText);
+    REQUIRE(largeText[1] == 'G');
+    REQUIRE(BasicBoard<4, 4>::fromString(std::string_view(
+                largeText, BasicBoard<4, 4>::NUM_POS)) == large);
+}
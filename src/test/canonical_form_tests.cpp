@@ -0,0 +1,160 @@
+#define CATCH_CONFIG_MAIN
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "../board.h"
+#include "../canonical_form.h"
+#include "catch.hpp"
+
+using namespace sudoku;
+using namespace std;
+
+// clang-format off
+
+const Board solved_board(
+    {
+        2, 9, 5, 7, 4, 3, 8, 6, 1,
+        4, 3, 1, 8, 6, 5, 9, 2, 7,
+        8, 7, 6, 1, 9, 2, 5, 4, 3,
+        3, 8, 7, 4, 5, 9, 2, 1, 6,
+        6, 1, 2, 3, 8, 7, 4, 9, 5,
+        5, 4, 9, 2, 1, 6, 7, 3, 8,
+        7, 6, 3, 5, 2, 4, 1, 8, 9,
+        9, 2, 8, 6, 7, 1, 3, 5, 4,
+        1, 5, 4, 9, 3, 8, 6, 7, 2,
+    }
+);
+
+const Board puzzle_board(
+    {
+        0, 0, 6, 0, 0, 8, 5, 0, 0,
+        0, 0, 0, 0, 7, 0, 6, 1, 3,
+        0, 0, 0, 0, 0, 0, 0, 0, 9,
+        0, 0, 0, 0, 9, 0, 0, 0, 1,
+        0, 0, 1, 0, 0, 0, 8, 0, 0,
+        4, 0, 0, 5, 3, 0, 0, 0, 0,
+        1, 0, 7, 0, 5, 3, 0, 0, 0,
+        0, 5, 0, 0, 6, 4, 0, 0, 0,
+        3, 0, 0, 1, 0, 0, 0, 6, 0,
+    }
+);
+
+const Board sparse_board(
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 7, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 9,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 1, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 5, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        3, 0, 0, 0, 0, 0, 0, 6, 0,
+    }
+);
+
+// clang-format on
+
+// Generates a random Sudoku symmetry.
+Transform randomTransform(mt19937 &randEngine) {
+    Transform transform;
+    transform.transposed = randEngine() % 2 == 1;
+    for (uint8_t *map : {transform.rowMap, transform.colMap}) {
+        uint8_t bands[3] = {0, 1, 2};
+        shuffle(begin(bands), end(bands), randEngine);
+        for (uint8_t band = 0; band < 3; band++) {
+            uint8_t rows[3] = {0, 1, 2};
+            shuffle(begin(rows), end(rows), randEngine);
+            for (uint8_t row = 0; row < 3; row++) {
+                map[band * 3 + row] =
+                    static_cast<uint8_t>(bands[band] * 3 + rows[row]);
+            }
+        }
+    }
+    shuffle(begin(transform.valueMap) + 1, end(transform.valueMap), randEngine);
+    return transform;
+}
+
+TEST_CASE("Transforms can be reverted") {
+    mt19937 randEngine(42);
+    for (int i = 0; i < 20; i++) {
+        const Transform transform = randomTransform(randEngine);
+        const Board transformed = applyTransform(puzzle_board, transform);
+        REQUIRE(transformed.isValid());
+        REQUIRE(transformed.blankPositionCount() ==
+                puzzle_board.blankPositionCount());
+        REQUIRE(revertTransform(transformed, transform) == puzzle_board);
+    }
+}
+
+TEST_CASE("Canonical form is the same for isomorphic boards") {
+    mt19937 randEngine(7);
+    for (const Board &board : {puzzle_board, solved_board, sparse_board}) {
+        const Board canonical = canonicalize(board);
+        REQUIRE(canonical.isValid());
+        REQUIRE(canonical.blankPositionCount() == board.blankPositionCount());
+        REQUIRE(canonicalize(canonical) == canonical);
+        for (int i = 0; i < 20; i++) {
+            const Board isomorphic =
+                applyTransform(board, randomTransform(randEngine));
+            REQUIRE(canonicalize(isomorphic) == canonical);
+        }
+    }
+}
+
+TEST_CASE("Canonical form of a solved board starts with 1 to 9") {
+    const Board canonical = canonicalize(solved_board);
+    for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+        REQUIRE(canonical.valueAt(0, col) == col + 1);
+    }
+}
+
+TEST_CASE("Invalid boards are returned unchanged") {
+    vector<uint8_t> values(Board::NUM_POS, 0);
+    values[0] = 6;
+    values[2] = 6;
+    const Board invalid(values);
+    REQUIRE_FALSE(invalid.isValid());
+    Transform transform;
+    transform.transposed = true;
+    REQUIRE(canonicalize(invalid, &transform) == invalid);
+    REQUIRE_FALSE(transform.transposed);
+    REQUIRE(applyTransform(invalid, transform) == invalid);
+}
+
+TEST_CASE("Returned transform maps the board into its canonical form") {
+    mt19937 randEngine(11);
+    for (int i = 0; i < 10; i++) {
+        const Board board = applyTransform(puzzle_board,
+                                           randomTransform(randEngine));
+        Transform transform;
+        const Board canonical = canonicalize(board, &transform);
+        REQUIRE(applyTransform(board, transform) == canonical);
+        REQUIRE(revertTransform(canonical, transform) == board);
+    }
+}
+
+TEST_CASE("Canonicalization throughput") {
+    mt19937 randEngine(3);
+    const int numBoards = 200;
+    vector<Board> boards;
+    for (int i = 0; i < numBoards; i++) {
+        const Board &board = i % 2 == 0 ? puzzle_board : solved_board;
+        boards.push_back(applyTransform(board, randomTransform(randEngine)));
+    }
+    const auto startTime = chrono::steady_clock::now();
+    for (const Board &board : boards) {
+        canonicalize(board);
+    }
+    const auto elapsedMicros = chrono::duration_cast<chrono::microseconds>(
+                                   chrono::steady_clock::now() - startTime)
+                                   .count();
+    clog << "Canonicalized " << numBoards << " boards in " << elapsedMicros
+         << " microseconds." << endl;
+    REQUIRE(elapsedMicros > 0);
+}
@@ -0,0 +1,116 @@
+#define CATCH_CONFIG_MAIN
+
+#include "../board.h"
+#include "../difficulty_rating.h"
+#include "../generator.h"
+#include "../logical_solver.h"
+#include "catch.hpp"
+
+using namespace sudoku;
+
+// Puzzles with a single solution, from the easiest to the hardest.
+
+const Board singles_puzzle = Board::fromString(
+    "...7.19.."
+    ".6...2.8."
+    "..2...76."
+    ".57....2."
+    "4........"
+    "3..85..16"
+    "64......."
+    "1...9...5"
+    "..36.....");
+
+const Board naked_pair_puzzle = Board::fromString(
+    "...4....."
+    ".59...8.."
+    "....72..."
+    ".285..93."
+    "..6.3..28"
+    "93.....4."
+    ".......65"
+    ".843.5..."
+    "3.....1..");
+
+const Board xy_wing_puzzle = Board::fromString(
+    ".6..4...."
+    "..51...6."
+    "..3..29.5"
+    "...2..73."
+    "........."
+    ".31.892.."
+    "....1.38."
+    "5.8...4.."
+    "....9...6");
+
+// Needs guessing after the deductions get stuck.
+const Board search_puzzle = Board::fromString(
+    "1....7.9."
+    ".3..2...8"
+    "..96..5.."
+    "..53..9.."
+    ".1..8...2"
+    "6....4..."
+    "3......1."
+    ".4......7"
+    "..7...3..");
+
+TEST_CASE("rateDifficulty scores harder puzzles higher") {
+    const DifficultyRating singles = rateDifficulty(singles_puzzle);
+    const DifficultyRating nakedPair = rateDifficulty(naked_pair_puzzle);
+    const DifficultyRating xyWing = rateDifficulty(xy_wing_puzzle);
+    const DifficultyRating search = rateDifficulty(search_puzzle);
+
+    REQUIRE(singles.solvable);
+    REQUIRE(singles.solvedLogically);
+    REQUIRE(singles.hardestTechnique <= Technique::HiddenSingle);
+    REQUIRE(singles.level == PuzzleDifficulty::Easy);
+
+    REQUIRE(nakedPair.solvedLogically);
+    REQUIRE(nakedPair.hardestTechnique == Technique::NakedPair);
+    REQUIRE(nakedPair.level == PuzzleDifficulty::Medium);
+
+    REQUIRE(xyWing.solvedLogically);
+    REQUIRE(xyWing.hardestTechnique == Technique::XYWing);
+    REQUIRE(xyWing.level == PuzzleDifficulty::Hard);
+    REQUIRE(xyWing.numGuesses == 0);
+
+    REQUIRE(search.solvable);
+    REQUIRE_FALSE(search.solvedLogically);
+    REQUIRE(search.numGuesses > 0);
+    REQUIRE(search.level == PuzzleDifficulty::Hard);
+
+    REQUIRE(singles.score >= 1.0);
+    REQUIRE(singles.score < nakedPair.score);
+    REQUIRE(nakedPair.score < xyWing.score);
+    REQUIRE(xyWing.score < search.score);
+}
+
+TEST_CASE("rateDifficulty is deterministic") {
+    const DifficultyRating first = rateDifficulty(search_puzzle);
+    rateDifficulty(xy_wing_puzzle);
+    const DifficultyRating second = rateDifficulty(search_puzzle);
+    REQUIRE(first.score == second.score);
+    REQUIRE(first.numGuesses == second.numGuesses);
+}
+
+TEST_CASE("rateDifficulty gives no score to boards without solution") {
+    const DifficultyRating invalid = rateDifficulty(Board::fromString("55"));
+    REQUIRE_FALSE(invalid.solvable);
+    REQUIRE(invalid.score == 0.0);
+
+    // Valid, but the blank at the top right corner has no candidate left.
+    const Board unsolvableBoard = Board::fromString(
+        "12345678."
+        "........9");
+    const DifficultyRating unsolvable = rateDifficulty(unsolvableBoard);
+    REQUIRE_FALSE(unsolvable.solvable);
+    REQUIRE(unsolvable.score == 0.0);
+}
+
+TEST_CASE("rateDifficulty rates boards with several solutions") {
+    const DifficultyRating empty = rateDifficulty(Board());
+    REQUIRE(empty.solvable);
+    REQUIRE_FALSE(empty.solvedLogically);
+    REQUIRE(empty.level == PuzzleDifficulty::Hard);
+}
@@ -39,9 +39,12 @@ GeneratorResult generate(PuzzleDifficulty difficulty, Board &generatedBoard,
     clog << "Generating board with difficulty level '"
          << static_cast<int>(difficulty) << "' ..." << endl;
 
-    result = gen.asyncGenerate(difficulty, asyncGenProgress, asyncGenFinished);
-    if (result != GeneratorResult::AsyncGenSubmitted) {
-        return result;
+    // The finished callback may run before asyncGenerate returns, so the
+    // submission result must not overwrite the generation result.
+    const GeneratorResult submitResult =
+        gen.asyncGenerate(difficulty, asyncGenProgress, asyncGenFinished);
+    if (submitResult != GeneratorResult::AsyncGenSubmitted) {
+        return submitResult;
     }
 
     unsigned int numOfWaits = 0;
@@ -87,17 +90,17 @@ TEST_CASE("asyncGenerate can generate solvable EASY puzzle") {
     REQUIRE(solvedBoard.isComplete());
 
     vector<Board> genBoardSolutions;
-    SolverResult resultSolveAll = SolverResult::NoError;
-    resultSolveAll = solver.asyncSolveForGood(
+    atomic<bool> solveAllFinished{false};
+    auto submitResult = solver.asyncSolveForGood(
         genBoard, nullptr,
-        [&resultSolveAll, &genBoardSolutions](SolverResult result,
-                                              const vector<Board> &solutions) {
-            resultSolveAll = result;
+        [&solveAllFinished, &genBoardSolutions](SolverResult,
+                                                const vector<Board> &solutions) {
             genBoardSolutions = solutions;
+            solveAllFinished = true;
         },
         2);
-    while (resultSolveAll != SolverResult::NoError &&
-           resultSolveAll != SolverResult::AsyncSolvingCancelled) {
+    REQUIRE(submitResult == SolverResult::AsyncSolvingSubmitted);
+    while (!solveAllFinished) {
         this_thread::sleep_for(chrono::milliseconds(POLL_INTERVAL_RESULT_MILLI));
     }
     clog << "Number of solutions for generated board: "
@@ -126,17 +129,17 @@ TEST_CASE("asyncGenerate can generate solvable MEDIUM puzzle") {
     REQUIRE(solvedBoard.isComplete());
 
     vector<Board> genBoardSolutions;
-    SolverResult resultSolveAll = SolverResult::NoError;
-    resultSolveAll = solver.asyncSolveForGood(
+    atomic<bool> solveAllFinished{false};
+    auto submitResult = solver.asyncSolveForGood(
         genBoard, nullptr,
-        [&resultSolveAll, &genBoardSolutions](SolverResult result,
-                                              const vector<Board> &solutions) {
-            resultSolveAll = result;
+        [&solveAllFinished, &genBoardSolutions](SolverResult,
+                                                const vector<Board> &solutions) {
             genBoardSolutions = solutions;
+            solveAllFinished = true;
         },
         2);
-    while (resultSolveAll != SolverResult::NoError &&
-           resultSolveAll != SolverResult::AsyncSolvingCancelled) {
+    REQUIRE(submitResult == SolverResult::AsyncSolvingSubmitted);
+    while (!solveAllFinished) {
         this_thread::sleep_for(chrono::milliseconds(POLL_INTERVAL_RESULT_MILLI));
     }
     clog << "Number of solutions for generated board: "
@@ -164,17 +167,17 @@ TEST_CASE("asyncGenerate can generate solvable HARD puzzle") {
     REQUIRE(solvedBoard.isComplete());
 
     vector<Board> genBoardSolutions;
-    SolverResult resultSolveAll = SolverResult::NoError;
-    resultSolveAll = solver.asyncSolveForGood(
+    atomic<bool> solveAllFinished{false};
+    auto submitResult = solver.asyncSolveForGood(
         genBoard, nullptr,
-        [&resultSolveAll, &genBoardSolutions](SolverResult result,
-                                              const vector<Board> &solutions) {
-            resultSolveAll = result;
+        [&solveAllFinished, &genBoardSolutions](SolverResult,
+                                                const vector<Board> &solutions) {
             genBoardSolutions = solutions;
+            solveAllFinished = true;
         },
         2);
-    while (resultSolveAll != SolverResult::NoError &&
-           resultSolveAll != SolverResult::AsyncSolvingCancelled) {
+    REQUIRE(submitResult == SolverResult::AsyncSolvingSubmitted);
+    while (!solveAllFinished) {
         this_thread::sleep_for(chrono::milliseconds(POLL_INTERVAL_RESULT_MILLI));
     }
     clog << "Number of solutions for generated board: "
@@ -0,0 +1,305 @@
+#define CATCH_CONFIG_MAIN
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../board.h"
+#include "../logical_solver.h"
+#include "../solver.h"
+#include "catch.hpp"
+
+using namespace sudoku;
+using namespace std;
+
+// clang-format off
+
+const Board unsolvable_board (
+    {
+        5, 1, 6, 8, 4, 0, 7, 3, 2,
+        3, 0, 7, 6, 0, 5, 0, 0, 0,
+        8, 0, 9, 7, 0, 0, 0, 6, 5,
+        1, 3, 5, 0, 6, 0, 9, 0, 7,
+        4, 7, 2, 5, 9, 1, 0, 0, 6,
+        9, 6, 8, 3, 7, 0, 0, 5, 0,
+        2, 5, 3, 1, 8, 6, 0, 7, 4,
+        6, 8, 4, 2, 0, 7, 5, 0, 0,
+        7, 9, 1, 0, 5, 0, 6, 0, 8
+    }
+);
+
+const Board invalid_board (
+    {
+        5, 5, 6, 8, 4, 0, 7, 3, 2,
+        3, 0, 7, 6, 0, 5, 0, 0, 0,
+        8, 0, 9, 7, 0, 0, 0, 6, 5,
+        1, 3, 5, 0, 6, 0, 9, 0, 7,
+        4, 7, 2, 5, 9, 1, 0, 0, 6,
+        9, 6, 8, 3, 7, 0, 0, 5, 0,
+        2, 5, 3, 1, 8, 6, 0, 7, 4,
+        6, 8, 4, 2, 0, 7, 5, 0, 0,
+        7, 9, 1, 0, 5, 0, 6, 0, 8
+    }
+);
+
+// clang-format on
+
+// Puzzles with a single solution, each one needing a technique at most.
+const Board naked_single_puzzle = Board::fromString(
+    "...7.19.."
+    ".6...2.8."
+    "..2...76."
+    ".57....2."
+    "4........"
+    "3..85..16"
+    "64......."
+    "1...9...5"
+    "..36.....");
+
+const Board hidden_single_puzzle = Board::fromString(
+    ".78.9..5."
+    "......4.."
+    "2.3..8.9."
+    "...8....2"
+    "..2.3...."
+    "9...6...."
+    ".87......"
+    "364...98."
+    ".....7..6");
+
+const Board locked_candidates_puzzle = Board::fromString(
+    "98...6..1"
+    "...4319.."
+    "...9....."
+    "8......4."
+    ".6......."
+    ".148.5.6."
+    "7....8.1."
+    "....4.7.9"
+    ".4..2...8");
+
+const Board naked_pair_puzzle = Board::fromString(
+    "...4....."
+    ".59...8.."
+    "....72..."
+    ".285..93."
+    "..6.3..28"
+    "93.....4."
+    ".......65"
+    ".843.5..."
+    "3.....1..");
+
+const Board hidden_pair_puzzle = Board::fromString(
+    "1...73.4."
+    "....4...9"
+    "...1..6.."
+    ".9...2..."
+    ".6.3..5.."
+    ".845...6."
+    "...4....7"
+    "....2...."
+    "8.7..5.3.");
+
+const Board naked_triple_puzzle = Board::fromString(
+    "36...92.."
+    "....4...."
+    "2.1....8."
+    "...7...1."
+    "7.8..4.3."
+    "....35..8"
+    "....1...6"
+    "95......."
+    "..4......");
+
+const Board hidden_triple_puzzle = Board::fromString(
+    ".....8.14"
+    "...1.7..."
+    "....2...."
+    "2..7....."
+    ".8...4.59"
+    ".4..5.6.."
+    "..5.9...1"
+    "..8.....2"
+    ".9.63...5");
+
+const Board naked_quad_puzzle = Board::fromString(
+    ".6.5.8..7"
+    "...43...."
+    "......5.8"
+    "...2....."
+    "........1"
+    "1.3.4..89"
+    "829...7.3"
+    "3.1.9...6"
+    ".........");
+
+const Board hidden_quad_puzzle = Board::fromString(
+    ".3..2.1.."
+    ".....45.."
+    "78......."
+    "........."
+    "9..1.3..."
+    "1.875...."
+    "..3.754.."
+    "8.5.....3"
+    ".1....89.");
+
+const Board x_wing_puzzle = Board::fromString(
+    ".724.1.9."
+    "..1......"
+    "5.....46."
+    ".2.6....."
+    "6.5.8.7.."
+    "..97....5"
+    "..79....."
+    ".......3."
+    "8...5...4");
+
+const Board swordfish_puzzle = Board::fromString(
+    ".7...93.5"
+    "........."
+    "3..8.4.2."
+    "..649...."
+    ".9..537.."
+    "1.....4.."
+    "24..6.5.1"
+    ".....8..7"
+    "...2...6.");
+
+const Board xy_wing_puzzle = Board::fromString(
+    ".6..4...."
+    "..51...6."
+    "..3..29.5"
+    "...2..73."
+    "........."
+    ".31.892.."
+    "....1.38."
+    "5.8...4.."
+    "....9...6");
+
+const Board simple_coloring_puzzle = Board::fromString(
+    "........8"
+    ".....8491"
+    "35......."
+    "9.2..6..."
+    "176......"
+    "...94..7."
+    "...7.9.3."
+    "....3.61."
+    "..5.....9");
+
+// Needs a color trap on a position that belongs to an earlier chain of the
+// same value.
+const Board two_chains_coloring_puzzle = Board::fromString(
+    "9.24.6..5"
+    ".869....."
+    ".4...1..6"
+    ".3.8.5..."
+    "..1......"
+    "......8.2"
+    "...51...."
+    ".5.....23"
+    "7....3.9.");
+
+// Checks that every step of the trace agrees with the solution of a puzzle.
+void requireStepsAgree(const LogicalSolver &logicalSolver,
+                       const Board &solution) {
+    for (const LogicalStep &step : logicalSolver.steps()) {
+        const uint8_t value = solution.valueAt(step.pos / Board::NUM_COLS,
+                                               step.pos % Board::NUM_COLS);
+        if (step.placement) {
+            REQUIRE(step.values == value);
+        } else {
+            REQUIRE(step.values != 0);
+            REQUIRE((step.values & (1U << (value - 1U))) == 0);
+        }
+    }
+}
+
+TEST_CASE("LogicalSolver reports the hardest technique needed") {
+    const pair<Board, Technique> cases[]{
+        {naked_single_puzzle, Technique::NakedSingle},
+        {hidden_single_puzzle, Technique::HiddenSingle},
+        {locked_candidates_puzzle, Technique::LockedCandidates},
+        {naked_pair_puzzle, Technique::NakedPair},
+        {hidden_pair_puzzle, Technique::HiddenPair},
+        {naked_triple_puzzle, Technique::NakedTriple},
+        {hidden_triple_puzzle, Technique::HiddenTriple},
+        {naked_quad_puzzle, Technique::NakedQuad},
+        {hidden_quad_puzzle, Technique::HiddenQuad},
+        {x_wing_puzzle, Technique::XWing},
+        {swordfish_puzzle, Technique::Swordfish},
+        {xy_wing_puzzle, Technique::XYWing},
+        {simple_coloring_puzzle, Technique::SimpleColoring}};
+    Solver solver;
+    LogicalSolver logicalSolver;
+    for (const auto &[puzzle, technique] : cases) {
+        Board solution;
+        REQUIRE(solver.solve(puzzle, solution) == SolverResult::NoError);
+
+        REQUIRE(logicalSolver.solve(puzzle) == LogicalResult::Solved);
+        REQUIRE(logicalSolver.solved());
+        REQUIRE(logicalSolver.board() == solution);
+        REQUIRE(logicalSolver.hardestTechnique() == technique);
+        REQUIRE(logicalSolver.timesUsed(technique) > 0);
+        requireStepsAgree(logicalSolver, solution);
+    }
+}
+
+TEST_CASE("Simple coloring traps positions of earlier chains") {
+    Solver solver;
+    Board solution;
+    REQUIRE(solver.solve(two_chains_coloring_puzzle, solution) ==
+            SolverResult::NoError);
+
+    LogicalSolver logicalSolver;
+    REQUIRE(logicalSolver.solve(two_chains_coloring_puzzle) ==
+            LogicalResult::Solved);
+    REQUIRE(logicalSolver.board() == solution);
+    REQUIRE(logicalSolver.hardestTechnique() == Technique::SimpleColoring);
+    requireStepsAgree(logicalSolver, solution);
+}
+
+TEST_CASE("LogicalSolver trace has a placement per blank position") {
+    LogicalSolver logicalSolver;
+    REQUIRE(logicalSolver.solve(xy_wing_puzzle) == LogicalResult::Solved);
+
+    size_t numPlacements = 0;
+    size_t numApplications = 0;
+    for (const LogicalStep &step : logicalSolver.steps()) {
+        numPlacements += step.placement ? 1 : 0;
+        numApplications += step.first ? 1 : 0;
+    }
+    REQUIRE(numPlacements == xy_wing_puzzle.blankPositionCount());
+    REQUIRE(logicalSolver.steps().front().first);
+
+    size_t numTimesUsed = 0;
+    for (size_t technique = 0; technique < NUM_TECHNIQUES; technique++) {
+        numTimesUsed +=
+            logicalSolver.timesUsed(static_cast<Technique>(technique));
+    }
+    REQUIRE(numApplications == numTimesUsed);
+}
+
+TEST_CASE("LogicalSolver steps through the cheapest deductions") {
+    LogicalSolver logicalSolver;
+    REQUIRE(logicalSolver.load(naked_single_puzzle));
+    const size_t numSteps = logicalSolver.step();
+    REQUIRE(numSteps > 0);
+    REQUIRE(logicalSolver.steps().size() == numSteps);
+    REQUIRE(logicalSolver.steps().front().technique == Technique::NakedSingle);
+    REQUIRE(logicalSolver.board().blankPositionCount() <
+            naked_single_puzzle.blankPositionCount());
+}
+
+TEST_CASE("LogicalSolver tells boards it can't solve apart") {
+    LogicalSolver logicalSolver;
+    REQUIRE(logicalSolver.solve(invalid_board) == LogicalResult::InvalidBoard);
+    REQUIRE(logicalSolver.solve(unsolvable_board) ==
+            LogicalResult::HasNoSolution);
+    REQUIRE(logicalSolver.contradiction());
+
+    // A board with many solutions gives no foothold to deductions.
+    REQUIRE(logicalSolver.solve(Board()) == LogicalResult::Stuck);
+    REQUIRE(logicalSolver.steps().empty());
+    REQUIRE(logicalSolver.candidates(0, 0).size() == Board::MAX_VAL);
+}
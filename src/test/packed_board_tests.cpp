@@ -0,0 +1,103 @@
+#define CATCH_CONFIG_MAIN
+
+#include <unordered_set>
+#include <vector>
+
+#include "../board.h"
+#include "../packed_board.h"
+#include "catch.hpp"
+
+using namespace sudoku;
+
+const Board solved_board(
+    // clang-format off
+    {
+        2, 9, 5, 7, 4, 3, 8, 6, 1,
+        4, 3, 1, 8, 6, 5, 9, 2, 7,
+        8, 7, 6, 1, 9, 2, 5, 4, 3,
+        3, 8, 7, 4, 5, 9, 2, 1, 6,
+        6, 1, 2, 3, 8, 7, 4, 9, 5,
+        5, 4, 9, 2, 1, 6, 7, 3, 8,
+        7, 6, 3, 5, 2, 4, 1, 8, 9,
+        9, 2, 8, 6, 7, 1, 3, 5, 4,
+        1, 5, 4, 9, 3, 8, 6, 7, 2,
+    }  // clang-format on
+);
+
+const Board board_with_blanks(
+    // clang-format off
+    {
+        2, 9, 5, 7, 0, 3, 8, 6, 1,
+        4, 3, 1, 8, 6, 5, 9, 2, 7,
+        8, 7, 6, 1, 9, 2, 5, 4, 3,
+        3, 8, 7, 4, 5, 9, 2, 1, 6,
+        6, 1, 2, 3, 8, 7, 4, 9, 5,
+        5, 4, 9, 2, 1, 6, 7, 3, 8,
+        7, 6, 3, 5, 2, 4, 1, 8, 9,
+        9, 2, 8, 6, 7, 1, 3, 5, 4,
+        1, 0, 4, 9, 3, 8, 6, 7, 2,
+    }  // clang-format on
+);
+
+const Board invalid_board_value_range(
+    // clang-format off
+    {
+        2, 19, 5, 7, 4, 3, 8, 6, 1, // 19 in the second column is out of range.
+        4,  3, 1, 8, 6, 5, 9, 2, 7,
+        8,  7, 6, 1, 9, 2, 5, 4, 3,
+        3,  8, 7, 4, 5, 9, 2, 1, 6,
+        6,  1, 2, 3, 8, 7, 4, 9, 5,
+        5,  4, 9, 2, 1, 6, 7, 3, 8,
+        7,  6, 3, 5, 2, 4, 1, 8, 9,
+        9,  2, 8, 6, 7, 1, 3, 5, 4,
+        1,  5, 4, 9, 3, 8, 6, 7, 2,
+    }  // clang-format on
+);
+
+TEST_CASE("PackedBoard takes two positions per byte") {
+    REQUIRE(sizeof(PackedBoard) == 41);
+}
+
+TEST_CASE("Default PackedBoard unpacks to an empty board") {
+    PackedBoard packed;
+    REQUIRE(packed.unpack().isEmpty());
+    REQUIRE(packed == PackedBoard(Board()));
+}
+
+TEST_CASE("Pack and unpack round trip preserves the board") {
+    for (const Board &board : {solved_board, board_with_blanks}) {
+        const PackedBoard packed(board);
+        const Board unpacked = packed.unpack();
+        REQUIRE(unpacked == board);
+        REQUIRE(unpacked.isValid());
+        REQUIRE(unpacked.blankPositionCount() == board.blankPositionCount());
+        for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+            for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+                REQUIRE(packed.valueAt(lin, col) == board.valueAt(lin, col));
+            }
+        }
+    }
+}
+
+TEST_CASE("Packed out-of-range value keeps the board invalid") {
+    const Board unpacked = PackedBoard(invalid_board_value_range).unpack();
+    REQUIRE(!unpacked.isValid());
+    const auto invalidPos = unpacked.getInvalidPositions();
+    REQUIRE(invalidPos.size() == 1);
+    REQUIRE(invalidPos[0].first == 0);
+    REQUIRE(invalidPos[0].second == 1);
+}
+
+TEST_CASE("Packed boards can be compared and hashed") {
+    const PackedBoard packedSolved(solved_board);
+    const PackedBoard packedBlanks(board_with_blanks);
+    REQUIRE(packedSolved == PackedBoard(solved_board));
+    REQUIRE(packedSolved != packedBlanks);
+    REQUIRE(packedSolved.hash() == PackedBoard(solved_board).hash());
+    REQUIRE(packedSolved.hash() != packedBlanks.hash());
+
+    std::unordered_set<PackedBoard> bank{packedSolved, packedBlanks,
+                                         PackedBoard(solved_board)};
+    REQUIRE(bank.size() == 2);
+    REQUIRE(bank.count(PackedBoard(board_with_blanks)) == 1);
+}
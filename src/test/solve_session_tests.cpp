@@ -0,0 +1,141 @@
+#define CATCH_CONFIG_MAIN
+
+#include <cstdint>
+
+#include "../board.h"
+#include "../solve_session.h"
+#include "../solver.h"
+#include "catch.hpp"
+
+using namespace sudoku;
+
+// clang-format off
+
+const Board unsolvable_board (
+    {
+        5, 1, 6, 8, 4, 0, 7, 3, 2,
+        3, 0, 7, 6, 0, 5, 0, 0, 0,
+        8, 0, 9, 7, 0, 0, 0, 6, 5,
+        1, 3, 5, 0, 6, 0, 9, 0, 7,
+        4, 7, 2, 5, 9, 1, 0, 0, 6,
+        9, 6, 8, 3, 7, 0, 0, 5, 0,
+        2, 5, 3, 1, 8, 6, 0, 7, 4,
+        6, 8, 4, 2, 0, 7, 5, 0, 0,
+        7, 9, 1, 0, 5, 0, 6, 0, 8
+    }
+);
+
+// clang-format on
+
+// A puzzle with a single solution.
+const Board unique_puzzle = Board::fromString(
+    "...7.19.."
+    ".6...2.8."
+    "..2...76."
+    ".57....2."
+    "4........"
+    "3..85..16"
+    "64......."
+    "1...9...5"
+    "..36.....");
+
+// Whether a board is a solution of another one.
+bool solves(const Board &solution, const Board &board) {
+    if (!solution.isComplete() || !solution.isValid()) {
+        return false;
+    }
+    for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            const uint8_t value = board.valueAt(lin, col);
+            if (value != 0 && solution.valueAt(lin, col) != value) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST_CASE("SolveSession validates edits that agree with the solution") {
+    SolveSession session(unique_puzzle);
+    REQUIRE(session.result() == SolverResult::NoError);
+    REQUIRE(session.numSearches() == 1);
+
+    Solver solver;
+    Board solution;
+    REQUIRE(solver.solve(unique_puzzle, solution) == SolverResult::NoError);
+    REQUIRE(session.solution() == solution);
+
+    // Fills the whole board with the solution, clearing a value on the way.
+    for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            REQUIRE(session.setValueAt(lin, col, solution.valueAt(lin, col)) ==
+                    SolverResult::NoError);
+        }
+    }
+    REQUIRE(session.setValueAt(4, 4, 0) == SolverResult::NoError);
+    REQUIRE(session.board().blankPositionCount() == 1);
+    REQUIRE(session.numSearches() == 1);
+}
+
+TEST_CASE("SolveSession finds another solution after a diverging edit") {
+    SolveSession session{Board()};
+    REQUIRE(session.result() == SolverResult::NoError);
+    const uint8_t value = session.solution().valueAt(0, 0) % Board::MAX_VAL + 1;
+
+    REQUIRE(session.setValueAt(0, 0, value) == SolverResult::NoError);
+    REQUIRE(session.solution().valueAt(0, 0) == value);
+    REQUIRE(solves(session.solution(), session.board()));
+    // Swapping two values of the last solution was enough.
+    REQUIRE(session.numSearches() == 2);
+
+    REQUIRE(session.setValueAt(0, 1, value % Board::MAX_VAL + 1) ==
+            SolverResult::NoError);
+    REQUIRE(session.setValueAt(4, 4, value) == SolverResult::NoError);
+    REQUIRE(solves(session.solution(), session.board()));
+}
+
+TEST_CASE("SolveSession tells when an edit leaves no solution") {
+    SolveSession session(unique_puzzle);
+    const Board solution = session.solution();
+    uint8_t wrongValue = 0;
+    for (const uint8_t value : session.board().getCandidates(0, 0)) {
+        if (value != solution.valueAt(0, 0)) {
+            wrongValue = value;
+            break;
+        }
+    }
+    REQUIRE(wrongValue != 0);
+
+    REQUIRE(session.setValueAt(0, 0, wrongValue) ==
+            SolverResult::HasNoSolution);
+    REQUIRE(session.result() == SolverResult::HasNoSolution);
+    const unsigned numSearches = session.numSearches();
+
+    // Undoing the edit makes the board solvable again, with the solution it
+    // had before.
+    REQUIRE(session.setValueAt(0, 0, 0) == SolverResult::NoError);
+    REQUIRE(session.solution() == solution);
+    REQUIRE(session.numSearches() == numSearches);
+}
+
+TEST_CASE("SolveSession rejects values that invalidate the board") {
+    SolveSession session(unique_puzzle);
+    // Line 0 already has a 7.
+    REQUIRE(session.setValueAt(0, 0, 7) == SolverResult::InvalidBoard);
+    REQUIRE(session.board() == unique_puzzle);
+    REQUIRE(session.result() == SolverResult::NoError);
+    REQUIRE(session.setValueAt(0, 0, Board::MAX_VAL + 1) ==
+            SolverResult::InvalidBoard);
+}
+
+TEST_CASE("SolveSession skips the search for constraints on boards without "
+          "solution") {
+    SolveSession session(unsolvable_board);
+    REQUIRE(session.result() == SolverResult::HasNoSolution);
+    const unsigned numSearches = session.numSearches();
+
+    const uint8_t value = session.board().getCandidates(1, 1).lowest();
+    REQUIRE(value != 0);
+    REQUIRE(session.setValueAt(1, 1, value) == SolverResult::HasNoSolution);
+    REQUIRE(session.numSearches() == numSearches);
+}
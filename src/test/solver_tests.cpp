@@ -1,13 +1,21 @@
 #define CATCH_CONFIG_MAIN
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <new>
 #include <string>
 #include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "../board.h"
+#include "../logical_solver.h"
 #include "../solver.h"
 #include "catch.hpp"
 
@@ -17,6 +25,106 @@ using namespace std;
 const int timeoutSecs = 240;
 const int maxBoardSolutions = 1'000;
 
+// Heap allocations made by the current thread while countAllocations is set.
+thread_local bool countAllocations = false;
+thread_local unsigned numAllocations = 0;
+
+// All the forms of the global operator new and delete are replaced, so that
+// none of them goes unaccounted for or frees memory it didn't allocate. The
+// helpers are kept out of line so that the compiler doesn't pair the malloc
+// of one with the free of the other.
+[[gnu::noinline]] void *allocate(size_t size, size_t alignment) noexcept {
+    if (countAllocations) {
+        numAllocations++;
+    }
+    size = max(size, size_t{1});
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        return malloc(size);
+    }
+    // aligned_alloc takes a multiple of the alignment.
+    const size_t alignedSize = (size + alignment - 1) / alignment * alignment;
+    return aligned_alloc(alignment, alignedSize);
+}
+
+[[gnu::noinline]] void deallocate(void *ptr) noexcept { free(ptr); }
+
+void *allocateOrThrow(size_t size, size_t alignment) {
+    if (void *ptr = allocate(size, alignment)) {
+        return ptr;
+    }
+    throw bad_alloc();
+}
+
+void *operator new(size_t size) {
+    return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](size_t size) {
+    return allocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(size_t size, align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<size_t>(alignment));
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept {
+    return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept {
+    return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(size_t size, align_val_t alignment,
+                   const nothrow_t &) noexcept {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void *operator new[](size_t size, align_val_t alignment,
+                     const nothrow_t &) noexcept {
+    return allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { deallocate(ptr); }
+
+void operator delete[](void *ptr, size_t) noexcept { deallocate(ptr); }
+
+void operator delete(void *ptr, align_val_t) noexcept { deallocate(ptr); }
+
+void operator delete[](void *ptr, align_val_t) noexcept { deallocate(ptr); }
+
+void operator delete(void *ptr, size_t, align_val_t) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void *ptr, size_t, align_val_t) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete(void *ptr, const nothrow_t &) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void *ptr, const nothrow_t &) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete(void *ptr, align_val_t, const nothrow_t &) noexcept {
+    deallocate(ptr);
+}
+
+void operator delete[](void *ptr, align_val_t, const nothrow_t &) noexcept {
+    deallocate(ptr);
+}
+
 // clang-format off
 
 const Board clear_board (
@@ -135,13 +243,14 @@ const Board solvable_too_many_solutions (
 // clang-format on
 
 SolverResult solveForGood(const Board &board, vector<Board> &solutions,
-                          unsigned limit = maxBoardSolutions) {
+                          unsigned limit = maxBoardSolutions,
+                          const SolverOptions &options = SolverOptions()) {
     SolverResult result{SolverResult::NoError};
     atomic<bool> finished{false};
     atomic<unsigned> solutionsFound(0u);
     atomic<unsigned> unsolvablesFound(0u);
     atomic<double> progressPercent(0.0);
-    Solver solver;
+    Solver solver(options);
 
     std::streamsize currentPrecision = clog.precision();
 
@@ -173,10 +282,12 @@ SolverResult solveForGood(const Board &board, vector<Board> &solutions,
         }
     };
 
-    result = solver.asyncSolveForGood(board, asyncSolveProgress,
-                                      asyncSolveFinished, limit);
-    if (result != SolverResult::AsyncSolvingSubmitted) {
-        return result;
+    // The finished callback may run before asyncSolveForGood returns, so the
+    // submission result must not overwrite the solving result.
+    const SolverResult submitResult = solver.asyncSolveForGood(
+        board, asyncSolveProgress, asyncSolveFinished, limit);
+    if (submitResult != SolverResult::AsyncSolvingSubmitted) {
+        return submitResult;
     }
 
     int numOfWaits = 0;
@@ -206,6 +317,45 @@ SolverResult solveForGood(const Board &board, vector<Board> &solutions,
     return result;
 }
 
+// The first solution in line-major order for a candidate order, found by
+// trying the values with Board::setValueAt.
+Board firstSolutionInOrder(const Board &board,
+                           const vector<uint8_t> &candidates) {
+    vector<pair<uint8_t, uint8_t>> emptyCells;
+    for (uint8_t lin = 0; lin < 9; lin++) {
+        for (uint8_t col = 0; col < 9; col++) {
+            if (board.valueAt(lin, col) == 0) {
+                emptyCells.emplace_back(lin, col);
+            }
+        }
+    }
+    Board solvedBoard(board);
+    size_t cell = 0;
+    while (cell < emptyCells.size()) {
+        const auto [lin, col] = emptyCells[cell];
+        const uint8_t value = solvedBoard.valueAt(lin, col);
+        size_t idx = value == 0 ? 0
+                                : find(candidates.begin(), candidates.end(),
+                                       value) -
+                                      candidates.begin() + 1;
+        while (idx < candidates.size() &&
+               solvedBoard.setValueAt(lin, col, candidates[idx]) !=
+                   SetValueResult::NoError) {
+            idx++;
+        }
+        if (idx < candidates.size()) {
+            cell++;
+        } else {
+            solvedBoard.setValueAt(lin, col, 0);
+            if (cell == 0) {
+                return Board();
+            }
+            cell--;
+        }
+    }
+    return solvedBoard;
+}
+
 TEST_CASE("Empty board is not solvable") {
     Board solved_board;
     Solver solver;
@@ -315,6 +465,69 @@ TEST_CASE("Cannot spawn more than one asyncSolveForGood simultaneously") {
     solver.cancelAsyncSolving();  // for graceful async solving exit.
 }
 
+TEST_CASE("asyncSolveForGood rejects a board with an out of range value") {
+    // A sparse board and a dense one, so that every engine would be picked.
+    vector<uint8_t> sparseValues(Board::NUM_POS, 0);
+    sparseValues[0] = 200;
+    vector<uint8_t> denseValues(Board::NUM_POS, 0);
+    for (size_t i = 0; i < Board::NUM_POS; i++) {
+        denseValues[i] = solvable_board.valueAt(static_cast<uint8_t>(i / 9),
+                                                static_cast<uint8_t>(i % 9));
+    }
+    denseValues[1] = 200;
+
+    for (const SolverEngine engine :
+         {SolverEngine::Auto, SolverEngine::Bitboard,
+          SolverEngine::DancingLinks, SolverEngine::Backtracking}) {
+        SolverOptions options;
+        options.engine = engine;
+        for (const Board &board :
+             {Board(sparseValues), Board(denseValues)}) {
+            vector<Board> solved_boards;
+            auto result = solveForGood(board, solved_boards, maxBoardSolutions,
+                                       options);
+            REQUIRE(result == SolverResult::InvalidBoard);
+            REQUIRE(solved_boards.empty());
+        }
+    }
+}
+
+TEST_CASE("asyncSolveForGood rejects a board with a repeated value") {
+    vector<uint8_t> sparseValues(Board::NUM_POS, 0);
+    // 5 is repeated in the first line.
+    sparseValues[0] = 5;
+    sparseValues[8] = 5;
+
+    for (const SolverEngine engine :
+         {SolverEngine::Auto, SolverEngine::Bitboard,
+          SolverEngine::DancingLinks, SolverEngine::Backtracking}) {
+        SolverOptions options;
+        options.engine = engine;
+        for (const Board &board : {Board(sparseValues), invalid_board}) {
+            vector<Board> solved_boards;
+            auto result = solveForGood(board, solved_boards, maxBoardSolutions,
+                                       options);
+            REQUIRE(result == SolverResult::InvalidBoard);
+            REQUIRE(solved_boards.empty());
+        }
+    }
+
+    // The rejected request leaves the solver free for the next one.
+    Solver solver;
+    REQUIRE(solver.asyncSolveForGood(invalid_board, nullptr, nullptr, 1U) ==
+            SolverResult::InvalidBoard);
+    atomic<bool> finished{false};
+    REQUIRE(solver.asyncSolveForGood(
+                solvable_one_solution, nullptr,
+                [&finished](SolverResult, const vector<Board> &) {
+                    finished = true;
+                },
+                1U) == SolverResult::AsyncSolvingSubmitted);
+    while (!finished) {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+}
+
 TEST_CASE(
     "asyncSolveForGood finds one solution for a difficult board "
     "with one solution") {
@@ -335,4 +548,528 @@ TEST_CASE(
     auto result = solveForGood(solvable_too_many_solutions, solved_boards);
     REQUIRE(result == SolverResult::NoError);
     REQUIRE(solved_boards.size() == maxBoardSolutions);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Solution found by solve keeps the values of the puzzle") {
+    // One of the hardest known puzzles for backtracking solvers.
+    const Board puzzle = Board::fromString(
+        "52...6..."
+        "......7.1"
+        "3........"
+        "...4..8.."
+        "6......5."
+        "........."
+        ".418....."
+        "....3..2."
+        "..87.....");
+    Board solved_board;
+    Solver solver;
+    REQUIRE(solver.solve(puzzle, solved_board) == SolverResult::NoError);
+    REQUIRE(solved_board.isComplete());
+    for (uint8_t lin = 0; lin < Board::NUM_ROWS; lin++) {
+        for (uint8_t col = 0; col < Board::NUM_COLS; col++) {
+            if (puzzle.valueAt(lin, col) != 0) {
+                REQUIRE(solved_board.valueAt(lin, col) ==
+                        puzzle.valueAt(lin, col));
+            }
+        }
+    }
+}
+
+TEST_CASE("Solutions found by asyncSolveForGood for a sparse board are distinct") {
+    vector<Board> solved_boards;
+    auto result = solveForGood(solvable_too_many_solutions, solved_boards, 200);
+    REQUIRE(result == SolverResult::NoError);
+    REQUIRE(solved_boards.size() == 200);
+    const unordered_set<Board> distinct(solved_boards.begin(),
+                                        solved_boards.end());
+    REQUIRE(distinct.size() == solved_boards.size());
+    for (const Board &solved_board : solved_boards) {
+        REQUIRE(solved_board.isComplete());
+        REQUIRE(solved_board.valueAt(0, 5) == 4);
+        REQUIRE(solved_board.valueAt(5, 1) == 6);
+    }
+}
+
+TEST_CASE("Every engine that can enumerate finds the same solutions") {
+    for (const SolverEngine engine :
+         {SolverEngine::Bitboard, SolverEngine::DancingLinks}) {
+        SolverOptions options;
+        options.engine = engine;
+
+        vector<Board> solved_boards;
+        auto result = solveForGood(solvable_three_solutions, solved_boards,
+                                   maxBoardSolutions, options);
+        REQUIRE(result == SolverResult::NoError);
+        REQUIRE(solved_boards.size() == 3);
+        REQUIRE(unordered_set<Board>(solved_boards.begin(),
+                                     solved_boards.end())
+                    .size() == 3);
+
+        Board solved_board;
+        Solver solver(options);
+        REQUIRE(solver.solve(solvable_board, solved_board) ==
+                SolverResult::NoError);
+        REQUIRE(solved_board.isComplete());
+    }
+}
+
+TEST_CASE("Engine without enumeration falls back to the automatic choice") {
+    SolverOptions options;
+    options.engine = SolverEngine::Backtracking;
+    Solver solver(options);
+    REQUIRE(solver.options().engine == SolverEngine::Backtracking);
+
+    // Backtracking only finds the first solution, so enumeration must be
+    // carried out by another engine.
+    vector<Board> solved_boards;
+    auto result = solveForGood(solvable_three_solutions, solved_boards,
+                               maxBoardSolutions, options);
+    REQUIRE(result == SolverResult::NoError);
+    REQUIRE(solved_boards.size() == 3);
+
+    Board solved_board;
+    REQUIRE(solver.solve(solvable_one_solution, solved_board) ==
+            SolverResult::NoError);
+    REQUIRE(solved_board.isComplete());
+}
+
+TEST_CASE("solve makes no allocation once the Solver is constructed") {
+    for (const SolverEngine engine :
+         {SolverEngine::Bitboard, SolverEngine::DancingLinks,
+          SolverEngine::Backtracking}) {
+        SolverOptions options;
+        options.engine = engine;
+        Solver solver(options);
+        Board solved_board;
+
+        numAllocations = 0;
+        countAllocations = true;
+        const SolverResult result = solver.solve(solvable_board, solved_board);
+        countAllocations = false;
+
+        REQUIRE(result == SolverResult::NoError);
+        REQUIRE(solved_board.isComplete());
+        REQUIRE(numAllocations == 0);
+    }
+}
+
+TEST_CASE("Synchronous calls can share a Solver across threads") {
+    Solver solver;
+    Board expected;
+    REQUIRE(solver.solve(solvable_one_solution, expected) ==
+            SolverResult::NoError);
+
+    atomic<int> numFailures{0};
+    vector<thread> threads;
+    for (int worker = 0; worker < 4; worker++) {
+        threads.emplace_back([&solver, &expected, &numFailures] {
+            for (int i = 0; i < 200; i++) {
+                Board solved_board;
+                if (solver.solve(solvable_one_solution, solved_board) !=
+                        SolverResult::NoError ||
+                    !(solved_board == expected) ||
+                    !solver.hasUniqueSolution(solvable_one_solution) ||
+                    solver.countSolutions(solvable_one_solution, 10) != 1) {
+                    numFailures++;
+                }
+            }
+        });
+    }
+    for (auto &workerThread : threads) {
+        workerThread.join();
+    }
+    REQUIRE(numFailures == 0);
+}
+
+TEST_CASE("asyncSolveForGood split among threads respects the limit") {
+    SolverOptions options;
+    options.numThreads = 4;
+
+    vector<Board> solved_boards;
+    auto result = solveForGood(solvable_too_many_solutions, solved_boards,
+                               maxBoardSolutions, options);
+    REQUIRE(result == SolverResult::NoError);
+    REQUIRE(solved_boards.size() == maxBoardSolutions);
+    REQUIRE(unordered_set<Board>(solved_boards.begin(), solved_boards.end())
+                .size() == solved_boards.size());
+
+    // A board with a single solution has its whole tree searched.
+    solved_boards.clear();
+    result = solveForGood(solvable_board, solved_boards, maxBoardSolutions,
+                          options);
+    REQUIRE(result == SolverResult::NoError);
+    REQUIRE(solved_boards.size() == 1);
+    REQUIRE(solved_boards[0].isComplete());
+}
+
+TEST_CASE("asyncSolveForGood split among threads finds the same solutions") {
+    SolverOptions options;
+    options.numThreads = 4;
+
+    vector<Board> first_boards;
+    vector<Board> solved_boards;
+    for (int run = 0; run < 5; run++) {
+        solved_boards.clear();
+        auto result = solveForGood(solvable_too_many_solutions, solved_boards,
+                                   maxBoardSolutions, options);
+        REQUIRE(result == SolverResult::NoError);
+        REQUIRE(solved_boards.size() == maxBoardSolutions);
+        if (run == 0) {
+            first_boards = solved_boards;
+        }
+        REQUIRE(solved_boards == first_boards);
+    }
+}
+
+TEST_CASE("hasUniqueSolution tells boards with a single solution apart") {
+    Solver solver;
+    Board solution;
+    REQUIRE(solver.hasUniqueSolution(solvable_one_solution, &solution));
+    REQUIRE(solution.isComplete());
+    Board solved_board;
+    REQUIRE(solver.solve(solvable_one_solution, solved_board) ==
+            SolverResult::NoError);
+    REQUIRE(solution == solved_board);
+
+    REQUIRE(solver.hasUniqueSolution(solvable_board));
+    REQUIRE_FALSE(solver.hasUniqueSolution(solvable_three_solutions));
+    REQUIRE_FALSE(solver.hasUniqueSolution(unsolvable_board));
+    REQUIRE_FALSE(solver.hasUniqueSolution(invalid_board));
+    REQUIRE_FALSE(solver.hasUniqueSolution(clear_board));
+}
+
+TEST_CASE("countSolutions counts up to the limit with every engine") {
+    for (const SolverEngine engine :
+         {SolverEngine::Auto, SolverEngine::Bitboard,
+          SolverEngine::DancingLinks, SolverEngine::Backtracking}) {
+        SolverOptions options;
+        options.engine = engine;
+        Solver solver(options);
+
+        REQUIRE(solver.countSolutions(solvable_three_solutions, 10) == 3);
+        REQUIRE(solver.countSolutions(solvable_three_solutions, 2) == 2);
+        REQUIRE(solver.countSolutions(solvable_three_solutions, 0) == 0);
+        REQUIRE(solver.countSolutions(solvable_one_solution, 10) == 1);
+        REQUIRE(solver.countSolutions(unsolvable_board, 10) == 0);
+        REQUIRE(solver.countSolutions(invalid_board, 10) == 0);
+        REQUIRE(solver.countSolutions(clear_board, maxBoardSolutions) ==
+                maxBoardSolutions);
+    }
+}
+
+TEST_CASE("countSolutions counts a sparse board exactly") {
+    const Board sparse_board = Board::fromString(
+        "..6...5.."
+        "....7..1."
+        "........9"
+        "....9...1"
+        "..1...8.."
+        "4...3...."
+        "1.7..3..."
+        ".5...4..."
+        "3.....6..");
+    const uint64_t numSolutions = 608'824;
+
+    for (const SolverEngine engine :
+         {SolverEngine::Bitboard, SolverEngine::DancingLinks}) {
+        SolverOptions options;
+        options.engine = engine;
+        options.numThreads = 4;
+        Solver solver(options);
+
+        REQUIRE(solver.countSolutions(sparse_board, numSolutions + 1) ==
+                numSolutions);
+        REQUIRE(solver.countSolutions(sparse_board, numSolutions + 1, true) ==
+                numSolutions);
+        REQUIRE(solver.countSolutions(sparse_board, 1'000, true) == 1'000);
+    }
+}
+
+TEST_CASE("solveBatch keeps the order and results of solve") {
+    const Board puzzles[]{solvable_board,       unsolvable_board,
+                          invalid_board,        solvable_one_solution,
+                          clear_board,          solvable_three_solutions};
+    const size_t numPuzzles = 120;
+    vector<Board> batch;
+    for (size_t i = 0; i < numPuzzles; i++) {
+        batch.push_back(puzzles[i % size(puzzles)]);
+    }
+
+    Solver solver;
+    vector<Board> expectedBoards(numPuzzles);
+    vector<SolverResult> expectedResults(numPuzzles);
+    size_t expectedSolved = 0;
+    for (size_t i = 0; i < numPuzzles; i++) {
+        expectedResults[i] = solver.solve(batch[i], expectedBoards[i]);
+        if (expectedResults[i] == SolverResult::NoError) {
+            expectedSolved++;
+        }
+    }
+
+    for (const unsigned numThreads : {1U, 4U}) {
+        BatchOptions batchOptions;
+        batchOptions.numThreads = numThreads;
+        batchOptions.chunkSize = 7;
+        vector<Board> solvedBoards(numPuzzles);
+        vector<SolverResult> results(numPuzzles);
+
+        const BatchStats stats =
+            solver.solveBatch(batch.data(), numPuzzles, solvedBoards.data(),
+                              results.data(), batchOptions);
+
+        REQUIRE(stats.numPuzzles == numPuzzles);
+        REQUIRE(stats.numSolved == expectedSolved);
+        REQUIRE(stats.numThreads == numThreads);
+        REQUIRE(results == expectedResults);
+        REQUIRE(solvedBoards == expectedBoards);
+    }
+
+    const BatchStats stats = solver.solveBatch(nullptr, 0, nullptr, nullptr);
+    REQUIRE(stats.numPuzzles == 0);
+    REQUIRE(stats.numSolved == 0);
+}
+
+TEST_CASE("solveWithCandidates finds the first solution in candidate order") {
+    vector<uint8_t> candidates{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    for (const Board &board :
+         {solvable_board, solvable_three_solutions, solvable_many_solutions}) {
+        for (int order = 0; order < 24; order++) {
+            Board solved_board;
+            REQUIRE(Solver::solveWithCandidates(board, candidates,
+                                                solved_board) ==
+                    SolverResult::NoError);
+            REQUIRE(solved_board == firstSolutionInOrder(board, candidates));
+            next_permutation(candidates.begin(), candidates.end());
+        }
+        reverse(candidates.begin(), candidates.end());
+    }
+}
+
+// Needs an XY-Wing, on top of simpler deductions, to be solved logically.
+const Board xy_wing_puzzle = Board::fromString(
+    ".6..4...."
+    "..51...6."
+    "..3..29.5"
+    "...2..73."
+    "........."
+    ".31.892.."
+    "....1.38."
+    "5.8...4.."
+    "....9...6");
+
+TEST_CASE("Following the hints of nextHint solves a puzzle") {
+    Solver solver;
+    Board solution;
+    REQUIRE(solver.solve(xy_wing_puzzle, solution) == SolverResult::NoError);
+
+    Board board = xy_wing_puzzle;
+    bool usedXYWing = false;
+    for (unsigned numHints = 0; !board.isComplete(); numHints++) {
+        REQUIRE(numHints < Board::NUM_POS * Board::MAX_VAL);
+        const Hint hint = solver.nextHint(board);
+        REQUIRE(hint.found);
+        REQUIRE(hint.numPositions >= 1);
+        const uint8_t value = solution.valueAt(hint.line, hint.column);
+        if (hint.placement) {
+            REQUIRE(hint.values == value);
+            REQUIRE(board.setValueAt(hint.line, hint.column, value) ==
+                    SetValueResult::NoError);
+        } else {
+            REQUIRE((hint.values & (1U << (value - 1U))) == 0);
+            usedXYWing |= hint.technique == Technique::XYWing;
+        }
+    }
+    REQUIRE(board == solution);
+    REQUIRE(usedXYWing);
+    REQUIRE_FALSE(solver.nextHint(board).found);
+}
+
+TEST_CASE("nextHint repeats a placement hint until it is followed") {
+    Solver solver;
+    const Hint hint = solver.nextHint(solvable_board);
+    REQUIRE(hint.found);
+    REQUIRE(hint.placement);
+
+    const Hint repeated = solver.nextHint(solvable_board);
+    REQUIRE(repeated.found);
+    REQUIRE(repeated.line == hint.line);
+    REQUIRE(repeated.column == hint.column);
+    REQUIRE(repeated.values == hint.values);
+
+    // A board edited in another way gets the hint a new Solver would give.
+    Board edited = solvable_board;
+    edited.setValueAt(0, 2, 0);
+    const Hint afterEdit = solver.nextHint(edited);
+    const Hint fresh = Solver().nextHint(edited);
+    REQUIRE(afterEdit.found == fresh.found);
+    REQUIRE(afterEdit.technique == fresh.technique);
+    REQUIRE(afterEdit.line == fresh.line);
+    REQUIRE(afterEdit.column == fresh.column);
+    REQUIRE(afterEdit.values == fresh.values);
+}
+
+TEST_CASE("nextHint makes no allocation after its first call") {
+    Solver solver;
+    Board board = solvable_board;
+    solver.nextHint(board);
+
+    numAllocations = 0;
+    countAllocations = true;
+    for (int i = 0; i < 10; i++) {
+        const Hint hint = solver.nextHint(board);
+        if (hint.found && hint.placement) {
+            board.setValueAt(hint.line, hint.column,
+                             static_cast<uint8_t>(hint.values));
+        }
+    }
+    countAllocations = false;
+    REQUIRE(numAllocations == 0);
+}
+
+TEST_CASE("nextHint finds nothing for boards beyond deductions") {
+    Solver solver;
+    REQUIRE_FALSE(solver.nextHint(invalid_board).found);
+    REQUIRE_FALSE(solver.nextHint(clear_board).found);
+    REQUIRE_FALSE(solver.nextHint(unsolvable_board).found);
+}
+
+TEST_CASE("nextHint finds nothing for deductions that reach a contradiction") {
+    // Valid, but the first deductions on it leave a position without values.
+    const Board board = Board::fromString(
+        "..6..85.."
+        "...27.613"
+        "........9"
+        "....9...1"
+        "..1...8.."
+        "4..53...."
+        "1.7.53.9."
+        ".5..64..."
+        "3..1...6.");
+    REQUIRE(board.isValid());
+    Solver solver;
+    REQUIRE(solver.countSolutions(board, 1) == 0);
+    REQUIRE_FALSE(solver.nextHint(board).found);
+    // Nor does it once the grid is kept between calls.
+    REQUIRE_FALSE(solver.nextHint(board).found);
+}
+
+TEST_CASE("solve reports the statistics of its search with every engine") {
+    for (const SolverEngine engine :
+         {SolverEngine::Bitboard, SolverEngine::DancingLinks,
+          SolverEngine::Backtracking}) {
+        SolverOptions options;
+        options.engine = engine;
+        Solver solver(options);
+        Board solved_board;
+        SolverStats stats;
+
+        REQUIRE(solver.solve(solvable_board, solved_board, &stats) ==
+                SolverResult::NoError);
+        REQUIRE(stats.setupSeconds >= 0.0);
+        REQUIRE(stats.searchSeconds > 0.0);
+        REQUIRE(stats.enginesCreated == 0);
+        REQUIRE(stats.solutionGrowths == 0);
+        if (SOLVER_STATS_ENABLED) {
+            REQUIRE(stats.nodes > 0);
+            REQUIRE(stats.backtracks <= stats.nodes);
+            REQUIRE(stats.maxDepth > 0);
+            REQUIRE(stats.maxDepth <= solvable_board.blankPositionCount());
+        } else {
+            REQUIRE(stats.nodes == 0);
+        }
+
+        // The statistics of a call don't carry over to the next one.
+        REQUIRE(solver.solve(invalid_board, solved_board, &stats) ==
+                SolverResult::InvalidBoard);
+        REQUIRE(stats.nodes == 0);
+        REQUIRE(stats.searchSeconds == 0.0);
+    }
+}
+
+TEST_CASE("Bitboard statistics count the eliminations of propagation") {
+    SolverOptions options;
+    options.engine = SolverEngine::Bitboard;
+    Solver solver(options);
+    Board solved_board;
+    SolverStats stats;
+    REQUIRE(solver.solve(solvable_board, solved_board, &stats) ==
+            SolverResult::NoError);
+    if (SOLVER_STATS_ENABLED) {
+        REQUIRE(stats.eliminations > 0);
+    }
+
+    // Stats are only counted when asked for.
+    REQUIRE(solver.solve(solvable_board, solved_board) ==
+            SolverResult::NoError);
+}
+
+TEST_CASE("solveWithCandidates reports the statistics of its search") {
+    Board solved_board;
+    SolverStats stats;
+    const vector<uint8_t> candidates{9, 8, 7, 6, 5, 4, 3, 2, 1};
+    REQUIRE(Solver::solveWithCandidates(solvable_board, candidates,
+                                        solved_board, &stats) ==
+            SolverResult::NoError);
+    // The backtracking engine is created for the call.
+    REQUIRE(stats.enginesCreated == 1);
+    if (SOLVER_STATS_ENABLED) {
+        REQUIRE(stats.nodes >= solvable_board.blankPositionCount());
+        REQUIRE(stats.backtracks > 0);
+        REQUIRE(stats.eliminations == 0);
+    }
+
+    const vector<uint8_t> tooFew{1, 2, 3};
+    REQUIRE(Solver::solveWithCandidates(solvable_board, tooFew,
+                                        solved_board) ==
+            SolverResult::InvalidatesCandidatesVector);
+    REQUIRE(Solver::solveWithCandidates(solvable_board, vector<uint8_t>(),
+                                        solved_board) ==
+            SolverResult::InvalidatesCandidatesVector);
+}
+
+TEST_CASE("asyncSolveForGood reports its statistics before finishing") {
+    for (const unsigned numThreads : {1U, 4U}) {
+        SolverOptions options;
+        options.numThreads = numThreads;
+        Solver solver(options);
+        SolverStats stats;
+        atomic<bool> finished{false};
+        atomic<unsigned> lastUnsolvables{0};
+        atomic<bool> unsolvablesDecreased{false};
+        atomic<uint64_t> nodesWhenFinished{0};
+
+        solver.asyncSolveForGood(
+            solvable_many_solutions,
+            [&lastUnsolvables, &unsolvablesDecreased](
+                double, unsigned unsolvables, unsigned) {
+                if (unsolvables < lastUnsolvables) {
+                    unsolvablesDecreased = true;
+                }
+                lastUnsolvables = unsolvables;
+            },
+            [&stats, &finished, &nodesWhenFinished](SolverResult,
+                                                    const vector<Board> &) {
+                nodesWhenFinished = stats.nodes;
+                finished = true;
+            },
+            maxBoardSolutions, &stats);
+        while (!finished) {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+
+        // An engine per thread.
+        REQUIRE(stats.enginesCreated == numThreads);
+        REQUIRE(stats.solutionGrowths > 0);
+        REQUIRE(stats.searchSeconds > 0.0);
+        REQUIRE(nodesWhenFinished == stats.nodes);
+        REQUIRE(lastUnsolvables <= stats.backtracks);
+        if (SOLVER_STATS_ENABLED) {
+            REQUIRE(stats.nodes > 0);
+            REQUIRE(stats.maxDepth > 0);
+        }
+        if (numThreads == 1) {
+            REQUIRE_FALSE(unsolvablesDecreased);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef UNIT_TABLES_H
+#define UNIT_TABLES_H
+
+#include <cstdint>
+
+#include "board.h"
+
+namespace sudoku {
+
+/**
+ * @brief Lookup tables of the units - lines, columns and sections - of a 9x9
+ * board, shared by the engines that keep candidates as bit masks.
+ */
+struct UnitTables {
+    static const std::uint8_t NUM_PEERS = 20;
+    static const std::uint8_t UNIT_SIZE = 9;
+
+    // Positions of each unit - lines, then columns, then sections.
+    std::uint8_t units[Board::NUM_UNITS][UNIT_SIZE]{};
+    // Line, column and section of each position.
+    std::uint8_t posUnits[Board::NUM_POS][3]{};
+    // Positions that share a unit with each position.
+    std::uint8_t peers[Board::NUM_POS][NUM_PEERS]{};
+
+    constexpr UnitTables() noexcept {
+        for (std::uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+            const std::uint8_t lin = pos / Board::NUM_COLS;
+            const std::uint8_t col = pos % Board::NUM_COLS;
+            const std::uint8_t sec = lin / 3 * 3 + col / 3;
+            posUnits[pos][0] = lin;
+            posUnits[pos][1] = Board::NUM_ROWS + col;
+            posUnits[pos][2] = Board::NUM_ROWS + Board::NUM_COLS + sec;
+            units[lin][col] = pos;
+            units[Board::NUM_ROWS + col][lin] = pos;
+            units[Board::NUM_ROWS + Board::NUM_COLS + sec]
+                 [lin % 3 * 3 + col % 3] = pos;
+        }
+        for (std::uint8_t pos = 0; pos < Board::NUM_POS; pos++) {
+            std::uint8_t nPeers = 0;
+            for (std::uint8_t other = 0; other < Board::NUM_POS; other++) {
+                const bool sharesUnit =
+                    posUnits[other][0] == posUnits[pos][0] ||
+                    posUnits[other][1] == posUnits[pos][1] ||
+                    posUnits[other][2] == posUnits[pos][2];
+                if (other != pos && sharesUnit) {
+                    peers[pos][nPeers++] = other;
+                }
+            }
+        }
+    }
+};
+
+inline constexpr UnitTables UNIT_TABLES;
+
+}  // namespace sudoku
+
+#endif